@@ -0,0 +1,139 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "allocationtest.h"
+
+#include "parser.h"
+#include "presentation.h"
+#include "slidelistdelegate.h"
+#include "slidelistmodel.h"
+#include "template.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QStyleOptionViewItem>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <optional>
+
+std::atomic<long> allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if(auto const pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+QTEST_MAIN(AllocationTest)
+
+namespace {
+
+// a rebuild copies the three boxes of a slide and resolves their styles, the styles
+// converted from the properties and variables come from the memo
+constexpr long maximalRebuildAllocationsPerSlide = 100;
+// painting a styled slide in the slide list only allocates the path of the painter,
+// the label and what Qt needs for the text of the three boxes
+constexpr long maximalPaintAllocations = 1000;
+
+std::shared_ptr<Template> presentationTemplate() {
+    auto output = generateSlides(QString("\\slide[defineclass: default] default\n"
+                                         "\\text[defineclass: title; font-size: 45]\n"
+                                         "\\text[class: pagenumber] %{pagenumber}\n"), {}, true);
+    auto const presentationTemplate = std::make_shared<Template>();
+    presentationTemplate->setData(output.takeSlideList());
+    return presentationTemplate;
+}
+
+SlideList slides(int numberSlides) {
+    QString text;
+    for(int i = 0; i < numberSlides; i++) {
+        text += QString("\\slide slide%1\n\\title Title %1\n\\body[color: red] text %1\n\\text[id: note%1] note\n").arg(i);
+    }
+    return generateSlides(text, {}).takeSlideList();
+}
+
+long allocations(std::function<void()> const& function) {
+    auto const before = allocationCount.load();
+    function();
+    return allocationCount - before;
+}
+
+// styles the data and builds all slides
+void rebuild(PresentationData& data) {
+    data.applyConfiguration(ConfigBoxes());
+    for(auto const& slide: data.slides().vector) {
+        slide->boxes();
+    }
+}
+
+}
+
+void AllocationTest::testHandoff() {
+    auto const sharedTemplate = presentationTemplate();
+    auto slideList = slides(200);
+    QCOMPARE(slideList.numberSlides(), 200);
+
+    // the slides are moved from the parser output into the data, only the empty defined classes are allocated
+    std::optional<PresentationData> data;
+    QVERIFY(allocations([&](){ data.emplace(std::move(slideList), sharedTemplate); }) <= 1);
+    rebuild(*data);
+
+    // handing the data to the presentation does not copy it
+    std::optional<PresentationData> moved;
+    QCOMPARE(allocations([&](){ moved.emplace(std::move(*data)); }), 0L);
+    QCOMPARE(moved->numberSlides(), 200);
+}
+
+void AllocationTest::testRebuild() {
+    auto const sharedTemplate = presentationTemplate();
+    // the first build fills the memo of the styles
+    PresentationData warmup(slides(10), sharedTemplate);
+    rebuild(warmup);
+
+    PresentationData small(slides(200), sharedTemplate);
+    auto const smallRebuild = allocations([&small](){ rebuild(small); });
+    PresentationData large(slides(400), sharedTemplate);
+    auto const largeRebuild = allocations([&large](){ rebuild(large); });
+
+    QVERIFY(smallRebuild <= maximalRebuildAllocationsPerSlide * small.numberSlides());
+    QVERIFY(largeRebuild <= maximalRebuildAllocationsPerSlide * large.numberSlides());
+    // the allocations grow with the number of slides and not faster
+    QVERIFY(largeRebuild <= 2 * smallRebuild + maximalRebuildAllocationsPerSlide);
+}
+
+void AllocationTest::testPaint() {
+    auto const sharedTemplate = presentationTemplate();
+    QImage image(320, 200, QImage::Format_ARGB32);
+    QPainter painter(&image);
+    SlideListDelegate const delegate;
+    QStyleOptionViewItem option;
+    option.rect = QRect(0, 0, 320, 200);
+
+    for(auto const numberSlides: {10, 2000}) {
+        auto const presentation = std::make_shared<Presentation>();
+        presentation->setData(PresentationData(slides(numberSlides), sharedTemplate));
+        SlideListModel model;
+        model.setPresentation(presentation);
+        QCOMPARE(model.rowCount(), numberSlides);
+
+        // the first paint builds the slide, compiles the markdown and fills the caches of the fonts
+        delegate.paint(&painter, option, model.index(0));
+        auto const repaint = allocations([&](){ delegate.paint(&painter, option, model.index(0)); });
+        QVERIFY2(repaint <= maximalPaintAllocations, qPrintable(QString("%1 allocations for %2 slides").arg(repaint).arg(numberSlides)));
+    }
+}
@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef ALLOCATIONTEST_H
+#define ALLOCATIONTEST_H
+
+#include <QtTest/QTest>
+
+// Counts the allocations of the build and the paint of a presentation. The test
+// replaces the global operator new, so it has a binary of its own.
+class AllocationTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testHandoff();
+    void testRebuild();
+    void testPaint();
+};
+
+#endif // ALLOCATIONTEST_H
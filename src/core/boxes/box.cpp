@@ -5,7 +5,6 @@
 */
 
 #include "box.h"
-#include <QRegularExpression>
 
 namespace{
 Qt::PenStyle CSSToPenStyle(QString cssStyle) {
@@ -153,28 +152,16 @@ void Box::setBoxStyle(BoxStyle style){
     mStyle = style;
 }
 
-QString Box::substituteVariables(QString text, std::map<QString, QString> variables) const {
-    if(variables.empty()){
-        return text;
+QString Box::substitutedText(Variables const& variables) const {
+    // the style can be changed in many places, a text that is not changed shares its data
+    // with the text of the template and is compared without looking at the characters
+    if(!mStyle.mText) {
+        return {};
     }
-    static QRegularExpression re("%{[^}]*}");
-    QRegularExpressionMatchIterator i = re.globalMatch(text);
-    QString newText = "";
-    int position = 0;
-    while(i.hasNext()){
-        QRegularExpressionMatch match = i.next();
-        auto const begin = match.capturedStart();
-        auto const end = match.capturedEnd();
-        newText.append(text.midRef(position, begin - position));
-        auto const foundExpression = text.mid(begin, end - begin);
-        if( variables.find(foundExpression) != variables.end() ) {
-            auto const value = variables.find(foundExpression)->second;
-            newText.append(value);
-            position = end;
-        }
+    if(!mTextTemplate || mTextTemplate->text() != mStyle.mText.value()) {
+        mTextTemplate = std::make_shared<TextTemplate const>(mStyle.mText.value());
     }
-    newText.append(text.midRef(position, text.size() - position));
-    return newText;
+    return mTextTemplate->substitute(variables);
 }
 
 void Box::setPauseCounter(int counter) {
@@ -209,7 +196,7 @@ void Box::setProperties(Box::Properties properties) {
     mProperties = properties;
 }
 
-void Box::setProperty(const QString &property, PropertyEntry const& entry) {
+void Box::setProperty(PropertyId property, PropertyEntry const& entry) {
     mProperties[property] = entry;
 }
 
@@ -8,11 +8,14 @@
 
 #include <QRect>
 #include <QPainter>
+#include <map>
 #include <memory>
 #include <optional>
 #include "boxgeometry.h"
+#include "property.h"
+#include "variables.h"
+#include "texttemplate.h"
 
-using Variables = std::map<QString, QString>;
 
 enum PresentationRenderHints {
     NoRenderHints = 1,
@@ -198,7 +201,7 @@ class Box
 public:
     using Ptr = std::shared_ptr<Box>;
     using List = std::vector<Ptr>;
-    using Properties = std::unordered_map<QString, PropertyEntry>;
+    using Properties = std::map<PropertyId, PropertyEntry>;
 
     // Implement this in child classes to draw the box's contents given the passed @p variables
     virtual void drawContent(QPainter& painter, PresentationContext const& context, PresentationRenderHints hints = PresentationRenderHints::NoRenderHints) = 0;
@@ -220,7 +223,7 @@ public:
     Box::Properties const& properties() const;
     Box::Properties& properties();
     void setProperties(Box::Properties properties);
-    void setProperty(QString const& property, const PropertyEntry &entry);
+    void setProperty(PropertyId property, const PropertyEntry &entry);
 
     void setBoxStyle(BoxStyle style);
     void setGeometry(BoxGeometry const& geometry);
@@ -249,8 +252,8 @@ public:
 
 protected:
     // Call this in child classes when implemting drawContent to substitute variables (e.g. page number)
-    // in text.
-    QString substituteVariables(QString text, std::map<QString, QString> variables) const;
+    // in the text of the box. The text is split at the variables when it changed since the last call.
+    QString substitutedText(Variables const& variables) const;
 
     struct PainterTransformScope {
         PainterTransformScope(Box* self, QPainter& painter)
@@ -276,4 +279,6 @@ private:
 private:
     Pause mPause = {PauseDisplayMode::fromPauseOn, 0};
     Box::Properties mProperties;
+    // split text of the last draw, the copies of the box share it
+    mutable std::shared_ptr<TextTemplate const> mTextTemplate;
 };
@@ -16,7 +16,7 @@ void CodeBox::drawContent(QPainter& painter, PresentationContext const& context,
     PainterTransformScope scope(this, painter);
     drawGlobalBoxSettings(painter);
 
-    auto const text = substituteVariables(style().text(), context.mVariables);
+    auto const text = substitutedText(context.mVariables);
     auto const paragraphs = text.split("\n");
     painter.setPen(mStyle.color());
     auto font = painter.font();
@@ -24,11 +24,11 @@ QRect boundingBox(QSize const& imageSize, QRect const& boxRect) {
 };
 
 QString absolutePath(QString &path, PresentationContext const& context) {
-    if(context.mVariables.find("%{templateresourcepath}") != context.mVariables.end()) {
-        return context.mVariables.at("%{templateresourcepath}") + "/" + path;
+    if(auto const templatePath = context.mVariables.value("%{templateresourcepath}")) {
+        return templatePath.value() + "/" + path;
     }
-    if(context.mVariables.find("%{resourcepath}") != context.mVariables.end()) {
-        return context.mVariables.at("%{resourcepath}") + "/" + path;
+    if(auto const resourcePath = context.mVariables.value("%{resourcepath}")) {
+        return resourcePath.value() + "/" + path;
     }
     return path;
 }
@@ -41,8 +41,8 @@ std::shared_ptr<Box> ImageBox::clone() {
 void ImageBox::drawContent(QPainter& painter, const PresentationContext &context, PresentationRenderHints hints){
     PainterTransformScope scope(this, painter);
     drawGlobalBoxSettings(painter);
-    auto path = substituteVariables(style().text(), context.mVariables);
-    if(!QDir::isAbsolutePath(path) && context.mVariables.find("%{resourcepath}") != context.mVariables.end()) {
+    auto path = substitutedText(context.mVariables);
+    if(!QDir::isAbsolutePath(path) && context.mVariables.contains("%{resourcepath}")) {
         path = absolutePath(path, context);
     }
     mImagePath = path;
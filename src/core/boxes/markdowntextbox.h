@@ -8,6 +8,7 @@
 #define TEXTFIELD_H
 
 #include "textbox.h"
+#include "markdowndocument.h"
 #include <QString>
 #include <QSize>
 
@@ -18,6 +19,12 @@ public:
 
     std::shared_ptr<Box> clone() override;
     void drawContent(QPainter& painter, PresentationContext const& context, PresentationRenderHints hints = PresentationRenderHints::NoRenderHints) override;
+
+private:
+    // taken from the memo on the first paint and when the text with the variables substituted
+    // changes, the copies of the box share it
+    std::shared_ptr<MarkdownDocument const> mDocument;
+    QString mDocumentText;
 };
 
 #endif // TEXTFIELD_H
@@ -17,7 +17,7 @@ void PlainTextBox::drawContent(QPainter& painter, const PresentationContext &con
     PainterTransformScope scope(this, painter);
     drawGlobalBoxSettings(painter);
 
-    auto const text = substituteVariables(style().text(), context.mVariables);
+    auto const text = substitutedText(context.mVariables);
     auto const paragraphs = text.split("\n");
 
     auto const linespacing = painter.fontMetrics().leading() + mStyle.linespacing() * painter.fontMetrics().lineSpacing();
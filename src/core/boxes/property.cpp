@@ -0,0 +1,57 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "property.h"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// sorted by name like the enum, so that the index is the id
+constexpr std::array<char16_t const*, int(PropertyId::Count)> propertyNames = {
+    u"angle",
+    u"background",
+    u"background-color",
+    u"border",
+    u"border-radius",
+    u"class",
+    u"color",
+    u"defineclass",
+    u"font-family",
+    u"font-size",
+    u"font-weight",
+    u"height",
+    u"highlight",
+    u"id",
+    u"language",
+    u"left",
+    u"line-height",
+    u"marker",
+    u"movable",
+    u"opacity",
+    u"padding",
+    u"text",
+    u"text-align",
+    u"top",
+    u"width"
+};
+
+}
+
+std::optional<PropertyId> propertyId(QStringView name) {
+    auto const found = std::lower_bound(propertyNames.begin(), propertyNames.end(), name, [](auto const& entry, QStringView name) {
+        return QStringView(entry) < name;
+    });
+    if(found == propertyNames.end() || QStringView(*found) != name) {
+        return {};
+    }
+    return PropertyId(found - propertyNames.begin());
+}
+
+QString propertyName(PropertyId id) {
+    return QString::fromUtf16(propertyNames[int(id)]);
+}
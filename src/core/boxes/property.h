@@ -0,0 +1,46 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <optional>
+
+// the properties that can be set in the squared brackets of a command,
+// the names are resolved once while parsing
+enum class PropertyId {
+    Angle,
+    Background,
+    BackgroundColor,
+    Border,
+    BorderRadius,
+    Class,
+    Color,
+    Defineclass,
+    FontFamily,
+    FontSize,
+    FontWeight,
+    Height,
+    Highlight,
+    Id,
+    Language,
+    Left,
+    LineHeight,
+    Marker,
+    Movable,
+    Opacity,
+    Padding,
+    Text,
+    TextAlign,
+    Top,
+    Width,
+    Count
+};
+
+// returns nothing if there is no property with the name
+std::optional<PropertyId> propertyId(QStringView name);
+QString propertyName(PropertyId id);
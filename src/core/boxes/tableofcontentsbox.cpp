@@ -4,10 +4,7 @@
 namespace {
 
 QString findVariable(PresentationContext const& context, QString const& variable) {
-    if(auto const value = context.mVariables.find(variable); value != context.mVariables.end()){
-        return value->second;
-    }
-    return {};
+    return context.mVariables.value(variable).value_or(QString());
 }
 }
 
@@ -22,7 +19,7 @@ void TableofContentsBox::drawContent(QPainter& painter, const PresentationContex
     auto startLine = QPointF(0, 0);
     auto const linespacing = painter.fontMetrics().leading() + mStyle.linespacing() * painter.fontMetrics().lineSpacing();
 
-    auto const tableofcontents = context.mTableOfContent;
+    auto const& tableofcontents = context.mTableOfContent;
     auto const currentSection = findVariable(context, "%{section}");
     auto const currentSubsection = findVariable(context, "%{subsection}");
 
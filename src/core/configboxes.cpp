@@ -112,3 +112,22 @@ MemberBoxGeometry ConfigBoxes::getRect(QString id) const{
     }
     return {};
 }
+
+std::vector<QString> ConfigBoxes::changedIds(ConfigBoxes const& other) const {
+    auto const sameEntry = [](JsonConfig const& a, JsonConfig const& b){
+        return a.geometry.angle == b.geometry.angle && a.geometry.rect == b.geometry.rect;
+    };
+    std::vector<QString> ids;
+    for(auto const& [id, config]: mConfigMap) {
+        auto const otherConfig = other.mConfigMap.find(id);
+        if(otherConfig == other.mConfigMap.end() || !sameEntry(config, otherConfig->second)) {
+            ids.push_back(id);
+        }
+    }
+    for(auto const& [id, config]: other.mConfigMap) {
+        if(mConfigMap.find(id) == mConfigMap.end()) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
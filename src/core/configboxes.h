@@ -39,6 +39,9 @@ public:
 
     MemberBoxGeometry getRect(QString id) const;
 
+    // ids of the boxes whose entries differ between the configurations
+    std::vector<QString> changedIds(ConfigBoxes const& other) const;
+
 private:
     void saveJsonConfigurations(QJsonObject &json, const JsonConfig config) const;
     JsonConfig readJsonConfigurations(const QJsonObject &json);
@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "difftest.h"
+
+#include "incrementalparser.h"
+#include "slidelistdiff.h"
+#include "variables.h"
+
+QTEST_MAIN(DiffTest)
+
+void DiffTest::testSlideListDiff() {
+    IncrementalParser parser;
+    auto const first = parser.parse("\\slide one\n\\text a\n\\slide two\n\\text b\n\\slide three\n\\text c\n", {}).slideList();
+    auto const second = parser.parse("\\slide one\n\\text a\n\\slide three\n\\text changed\n\\slide two\n\\text b\n", {}).slideList();
+
+    auto diff = diffSlideLists(first, second);
+    QCOMPARE(diff.oldPositions, std::vector<int>({0, 2, 1}));
+    QVERIFY(diff.inserted.empty());
+    QVERIFY(diff.removed.empty());
+    QCOMPARE(diff.moved, std::vector<int>({1}));
+    // the slide "two" has another page number
+    QCOMPARE(diff.modified, std::vector<int>({1, 2}));
+    QCOMPARE(int(diff.boxChanges.at(1).modified.size()), 1);
+    QVERIFY(diff.boxChanges.at(2).empty());
+    QVERIFY(!diff.changed(0));
+    QVERIFY(diffSlideLists(second, second).empty());
+
+    auto const third = parser.parse("\\slide one\n\\text a\n\\slide two\n\\text b\n\\slide four\n", {}).slideList();
+    diff = diffSlideLists(second, third);
+    QCOMPARE(diff.oldPositions, std::vector<int>({0, 2, -1}));
+    QCOMPARE(diff.inserted, std::vector<int>({2}));
+    QCOMPARE(diff.removed, std::vector<int>({1}));
+    QVERIFY(diff.moved.empty());
+}
+
+void DiffTest::testCompareVariables() {
+    Variables shared;
+    shared.set("%{title}", "Potato");
+    shared.set("%{speaker}", "Alice");
+    shared.share();
+    auto copy = shared;
+    QVERIFY(copy == shared);
+    copy.set("%{pagenumber}", "2");
+    QVERIFY(copy != shared);
+
+    // the same variables in another scope
+    Variables own;
+    own.set("%{title}", "Potato");
+    own.set("%{speaker}", "Alice");
+    QVERIFY(own == shared);
+    QVERIFY(shared == own);
+    own.remove("%{speaker}");
+    QVERIFY(own != shared);
+    QVERIFY(shared != own);
+
+    auto removed = shared;
+    removed.remove("%{speaker}");
+    QVERIFY(removed == own);
+    removed.setFallback(shared);
+    QVERIFY(removed == own);
+}
@@ -0,0 +1,20 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef DIFFTEST_H
+#define DIFFTEST_H
+
+#include <QtTest/QTest>
+
+class DiffTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSlideListDiff();
+    void testCompareVariables();
+};
+
+#endif // DIFFTEST_H
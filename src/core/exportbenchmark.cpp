@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "exportbenchmark.h"
+
+#include "parser.h"
+#include "pdfcreator.h"
+
+#include <QTemporaryDir>
+
+QTEST_MAIN(ExportBenchmark)
+
+namespace {
+
+// every third slide has a pause, so there are about 4/3 pages per slide
+SlideList parsedSlides(int numberSlides) {
+    QString text = "\\setvar color #333\n";
+    for(int i = 0; i < numberSlides; i++) {
+        text += QString("\\slide slide%1\n\\title Title %1\n\\body[font-size: 30] - first point\n- second point\n").arg(i);
+        if(i % 3 == 0) {
+            text += "\\pause\n\\text[left: 800] shown after the pause\n";
+        }
+    }
+    return generateSlides(text, {}).takeSlideList();
+}
+
+// the slides are styled when they are exported, so the styling is measured with the export
+Presentation::Ptr presentation(SlideList slides) {
+    auto presentation = std::make_shared<Presentation>();
+    presentation->setData(PresentationData(std::move(slides)));
+    return presentation;
+}
+
+void addRows() {
+    QTest::addColumn<int>("numberSlides");
+    for(auto const numberSlides: {10, 100, 500, 1000, 2000}) {
+        QTest::newRow(QString("%1 slides").arg(numberSlides).toUtf8()) << numberSlides;
+    }
+}
+
+}
+
+void ExportBenchmark::benchmarkExport() {
+    QFETCH(int, numberSlides);
+    QTemporaryDir directory;
+    PDFCreator creator;
+    auto const exported = presentation(parsedSlides(numberSlides));
+    QBENCHMARK_ONCE {
+        creator.createPdf(directory.filePath("export.pdf"), exported);
+    }
+}
+
+void ExportBenchmark::benchmarkExport_data() {
+    addRows();
+}
+
+void ExportBenchmark::benchmarkHandout() {
+    QFETCH(int, numberSlides);
+    QTemporaryDir directory;
+    PDFCreator creator;
+    auto const exported = presentation(parsedSlides(numberSlides));
+    QBENCHMARK_ONCE {
+        creator.createPdfHandout(directory.filePath("handout.pdf"), exported);
+    }
+}
+
+void ExportBenchmark::benchmarkHandout_data() {
+    addRows();
+}
@@ -0,0 +1,24 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef EXPORTBENCHMARK_H
+#define EXPORTBENCHMARK_H
+
+#include <QtTest/QTest>
+
+// Time of the PDF export for growing presentations, the time per page should
+// stay the same from 10 to 2000 pages.
+class ExportBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkExport();
+    void benchmarkExport_data();
+    void benchmarkHandout();
+    void benchmarkHandout_data();
+};
+
+#endif // EXPORTBENCHMARK_H
@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+// libFuzzer target for the potato and the markdown grammar. An input that takes
+// longer to parse than its time budget aborts, so that libFuzzer stores it as
+// crash file, run the fuzzer with the file as argument to reproduce it.
+// The budget grows linearly with the size of the input and can be scaled with
+// the environment variable POTATO_FUZZ_BUDGET (default 1.0).
+
+#include "antlr4-runtime.h"
+#include "markdownLexer.h"
+#include "markdownParser.h"
+#include "potatoLexer.h"
+#include "potatoParser.h"
+#include "twostageparse.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// time for an empty input and for every byte of the input in microseconds
+double const baseBudget = 100'000;
+double const budgetPerByte = 100;
+
+double budgetFactor() {
+    static double const factor = [](){
+        auto const value = std::getenv("POTATO_FUZZ_BUDGET");
+        return value ? std::atof(value) : 1.0;
+    }();
+    return factor;
+}
+
+template<typename Lexer, typename Parser, typename Context>
+void parse(std::string const& text, Context* (Parser::*rule)()) {
+    antlr4::ANTLRInputStream input;
+    try {
+        input.load(text);
+    }  catch (std::range_error const&) {
+        // the editor only passes valid UTF-8
+        return;
+    }
+    Lexer lexer(&input);
+    lexer.removeErrorListeners();
+    antlr4::CommonTokenStream tokens(&lexer);
+    tokens.fill();
+    Parser parser(&tokens);
+    parser.removeErrorListeners();
+    parseTwoStage(parser, rule);
+}
+
+template<typename Function>
+void checkBudget(char const* grammar, std::size_t size, Function function) {
+    auto const start = std::chrono::steady_clock::now();
+    function();
+    auto const time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    auto const budget = (baseBudget + budgetPerByte * double(size)) * budgetFactor();
+    if(time > budget) {
+        std::fprintf(stderr, "Parsing %zu bytes with the %s grammar took %.0f us, the budget is %.0f us.\n",
+                     size, grammar, time, budget);
+        std::abort();
+    }
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(std::uint8_t const* data, std::size_t size) {
+    auto const text = std::string(reinterpret_cast<char const*>(data), size);
+    checkBudget("potato", size, [&text](){
+        parse<potatoLexer>(text, &potatoParser::potato);
+    });
+    // the markdown boxes always end with a newline
+    checkBudget("markdown", size, [&text](){
+        parse<markdownLexer>(text + "\n", &markdownParser::markdown);
+    });
+    return 0;
+}
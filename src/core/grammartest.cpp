@@ -9,9 +9,12 @@
 #include "potatoParser.h"
 #include "potatoLexer.h"
 #include "potatoerrorlistener.h"
+#include "parser.h"
+#include "testdump.h"
 
 #include<QtDebug>
 #include<QBuffer>
+#include <QTemporaryFile>
 #include <memory>
 #include <string>
 
@@ -37,6 +40,89 @@ void GrammarTest::testGrammar() {
     QVERIFY(errorListener.success());
 }
 
+void GrammarTest::testNativeParser() {
+    QFETCH(QString, inputText);
+
+    auto const native = generateSlides(inputText, "", false, ParserBackend::Native);
+    auto const antlr = generateSlides(inputText, "", false, ParserBackend::ANTLR);
+    QCOMPARE(native.successfull(), antlr.successfull());
+    QCOMPARE(dump(native), dump(antlr));
+}
+
+void GrammarTest::testNativeParser_data() {
+    testGrammar_data();
+    // documents
+    QTest::newRow("slides") << "\\slide first\n\\title Title\n\\body\n * one\n * two\n\n\\slide second\n\\text[left: 10; top: 20] text";
+    QTest::newRow("preamble") << "\\usetemplate red\n\\setvar name Potato\n\\slide first\n\\title %{name}";
+    QTest::newRow("section") << "\\slide first\n\\section One\n\\slide second\n\\subsection Two\n\\slide third";
+    QTest::newRow("pause") << "\\slide first\n\\body one\n\\pause two\n\\pause\n\\pause three";
+    QTest::newRow("slide class") << "\\slide[class: titlepage] first\n\\slide[defineclass: titlepage] second";
+    QTest::newRow("property list over lines") << "\\slide first\n\\image[\n  left: 10;\n  top: 20;\n]\nimage.png";
+    QTest::newRow("value with spaces") << "\\slide first\n\\text[font: Linux  Biolinum ; color: #444]";
+    QTest::newRow("brackets with command") << "\\slide first\n\\code \\{\n\\slide not a slide\n\\}\n\\body after";
+    QTest::newRow("opening bracket only") << "\\slide first\n\\body \\{ no bracket";
+    QTest::newRow("space before bracket") << "\\slide first\n\\body [class: test] text";
+    QTest::newRow("space before bracket with text in brackets") << "\\slide first\n\\body [class: test] \\{text\\}";
+    QTest::newRow("newline before bracket") << "\\slide first\n\\body\n[class: test] text";
+    QTest::newRow("space before command in text") << "\\slide first\n\\body \\textbf";
+    QTest::newRow("lines with spaces") << "\\slide first\n\\body one\n   \n  two\n  \n\\body";
+    QTest::newRow("trailing spaces") << "\\slide first   \n\\body one   \n\n";
+    QTest::newRow("text after empty command") << "\\slide first\n\\body\n\ntext";
+    QTest::newRow("ignored after bracket") << "\\slide first\n\\body one\n[class: test]\n\\slide second";
+    QTest::newRow("unicode") << "\\slide first\n\\body \u00e4\u00f6\u00fc \u03c0 \U0001F954";
+    // errors
+    QTest::newRow("empty") << "";
+    QTest::newRow("no command") << "text";
+    QTest::newRow("missing newline") << "\\slide first\n\\title\\body";
+    QTest::newRow("space after backslash") << "\\slide first\n\\ body";
+    QTest::newRow("missing value") << "\\slide first\n\\body[class:]";
+    QTest::newRow("missing colon") << "\\slide first\n\\body[class test]";
+    QTest::newRow("unknown property") << "\\slide first\n\\body[colour: red]";
+    QTest::newRow("missing closing bracket") << "\\slide first\n\\body[class: test\n\\body";
+    QTest::newRow("text after brackets") << "\\slide first\n\\body \\{text\\} more";
+    QTest::newRow("invalid command") << "\\slide first\n\\unknown";
+    QTest::newRow("duplicated slide") << "\\slide first\n\\slide first";
+    // errors after valid slides
+    QTest::newRow("missing newline on later slide") << "\\slide first\n\\body one\n\\slide second\n\\title\\body";
+    QTest::newRow("missing colon after empty line") << "\\slide first\n\\body one\n\n\\slide second\n\\body[class test]";
+    QTest::newRow("invalid command after brackets") << "\\slide first\n\\code \\{\na\nb\n\\}\n\\unknown";
+    QTest::newRow("space after backslash on later slide") << "\\slide first\n\\slide second\n\\text two\n\\ body";
+}
+
+void GrammarTest::testFileParser() {
+    QFETCH(QString, inputText);
+    if(QByteArray(QTest::currentDataTag()) == "ignored after bracket") {
+        QSKIP("The file is split at every \\slide, so the slide after the ignored input is parsed.");
+    }
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(inputText.toUtf8());
+    file.close();
+    auto const fromFile = generateSlidesFromFile(file.fileName(), "");
+    auto const fromText = generateSlides(inputText, "");
+    QCOMPARE(fromFile.successfull(), fromText.successfull());
+    QCOMPARE(dump(fromFile), dump(fromText));
+}
+
+void GrammarTest::testFileParser_data() {
+    testNativeParser_data();
+}
+
+void GrammarTest::testManySlides() {
+    QString input;
+    for(int i = 0; i < 5000; i++) {
+        input.append(QString("\\slide slide%1\n\\text one\n\\text two\n").arg(i));
+    }
+    auto const output = generateSlides(input, "");
+    QVERIFY(output.successfull());
+    auto const slides = output.slideList();
+    QCOMPARE(slides.numberSlides(), 5000);
+    QCOMPARE(slides.findSlide("slide4999")->pagenumber(), 5000);
+    QVERIFY(slides.findBox("intern-slide4999-text-default-1"));
+    QVERIFY(!slides.findBox("intern-slide4999-text-default-2"));
+}
+
 void GrammarTest::testGrammar_data(){
     QTest::addColumn<QString>("inputText");
     QTest::newRow("only slide") << "\\slide first page";
@@ -15,6 +15,11 @@ class GrammarTest : public QObject
 private Q_SLOTS:
     void testGrammar();
     void testGrammar_data();
+    void testNativeParser();
+    void testNativeParser_data();
+    void testManySlides();
+    void testFileParser();
+    void testFileParser_data();
 };
 
 #endif // GRAMMARTEST_H
@@ -0,0 +1,256 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "incrementalparser.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+
+namespace {
+
+QString absoluteFileName(QString const& fileName, QString const& directory) {
+    return QFileInfo(QDir(directory), fileName).absoluteFilePath();
+}
+
+}
+
+ParserOutput IncrementalParser::parse(QString const& text, QString const& directory) {
+    auto const chunks = splitAtSlides(QStringView(text));
+    mUsedChunks.clear();
+    parseNewChunks(chunks);
+    parseIncludedFiles(chunks, directory);
+
+    // a chunk with a syntax error is replaced by the chunk at the same position of the last
+    // successfull run, this only works while no slide was inserted or removed
+    auto const canRecover = chunks.size() == mLastGoodChunks.size();
+    std::optional<ParserError> recoveredError;
+    std::vector<std::shared_ptr<ParsedChunk const>> goodChunks;
+    goodChunks.reserve(chunks.size());
+
+    SlideAssembler assembler(directory);
+    std::vector<QString> includeStack;
+    auto const includeHandler = [&](Include const& include) {
+        return appendIncludedFile(assembler, absoluteFileName(include.fileName, directory), include.line, includeStack);
+    };
+    for(std::size_t i = 0; i < chunks.size(); i++) {
+        auto const& chunk = chunks[i];
+        auto parsed = parsedChunk(chunk.text);
+        auto outdated = false;
+        if(parsed->mParserError && canRecover && mLastGoodChunks[i]) {
+            if(!recoveredError) {
+                recoveredError = parsed->mParserError.value();
+                recoveredError->line += chunk.line;
+            }
+            parsed = mLastGoodChunks[i];
+            outdated = true;
+        }
+        goodChunks.push_back(parsed);
+        // an empty preamble is no error
+        if(chunk.text.isEmpty() && chunks.size() > 1) {
+            continue;
+        }
+        if(auto const error = assembler.append(*parsed, chunk.line, outdated, includeHandler)) {
+            // keep the chunks of the last successfull run, so that they can be reused after the error is fixed
+            mChunks.merge(mUsedChunks);
+            mUsedChunks.clear();
+            auto output = ParserOutput(error.value());
+            output.mIncludedFiles = includedFiles();
+            return output;
+        }
+    }
+
+    mChunks = std::move(mUsedChunks);
+    mUsedChunks.clear();
+    mLastGoodChunks = std::move(goodChunks);
+    auto output = assembler.output();
+    output.mRecoveredError = recoveredError;
+    output.mIncludedFiles = includedFiles();
+    return output;
+}
+
+void IncrementalParser::clear() {
+    mChunks.clear();
+    mUsedChunks.clear();
+    mLastGoodChunks.clear();
+    mIncludedFiles.clear();
+    mStoredChunks.clear();
+    mCacheFile.clear();
+}
+
+void IncrementalParser::setCacheFile(QString const& fileName) {
+    mCacheFile = fileName;
+    mStoredChunks = readParseCache(fileName);
+}
+
+void IncrementalParser::saveCache() const {
+    if(mCacheFile.isEmpty()) {
+        return;
+    }
+    CachedChunks chunks;
+    for(auto const& [text, chunk]: mChunks) {
+        chunks[parseCacheKey(text)] = chunk;
+    }
+    writeParseCache(mCacheFile, chunks);
+}
+
+void IncrementalParser::parseNewChunks(std::vector<Chunk> const& chunks) {
+    std::vector<QStringView> newChunks;
+    std::unordered_set<QStringView, ChunkHash> seen;
+    for(auto const& chunk: chunks) {
+        if(chunk.text.isEmpty() || !seen.insert(chunk.text).second
+                || mUsedChunks.find(chunk.text) != mUsedChunks.end() || cachedChunk(chunk.text)) {
+            continue;
+        }
+        newChunks.push_back(chunk.text);
+    }
+    // a single chunk is parsed in parsedChunk without the overhead of the pool
+    if(newChunks.size() < 2) {
+        return;
+    }
+
+    // the chunks are independent of each other, everything that depends on the order
+    // of the slides is done afterwards in parse
+    std::vector<std::shared_ptr<ParsedChunk const>> parsed(newChunks.size());
+    for(std::size_t i = 0; i < newChunks.size(); i++) {
+        mParsePool.start([&parsed, &newChunks, i](){
+            parsed[i] = std::make_shared<ParsedChunk const>(parseChunk(newChunks[i]));
+        });
+    }
+    mParsePool.waitForDone();
+    for(std::size_t i = 0; i < newChunks.size(); i++) {
+        mUsedChunks.emplace(newChunks[i].toString(), parsed[i]);
+    }
+}
+
+std::shared_ptr<ParsedChunk const> IncrementalParser::cachedChunk(QStringView text) const {
+    if(auto const cached = mChunks.find(text); cached != mChunks.end()) {
+        return cached->second;
+    }
+    if(mStoredChunks.empty()) {
+        return {};
+    }
+    if(auto const stored = mStoredChunks.find(parseCacheKey(text)); stored != mStoredChunks.end()) {
+        return stored->second;
+    }
+    return {};
+}
+
+std::shared_ptr<ParsedChunk const> IncrementalParser::parsedChunk(QStringView text) {
+    if(auto const used = mUsedChunks.find(text); used != mUsedChunks.end()) {
+        return used->second;
+    }
+    auto chunk = cachedChunk(text);
+    if(!chunk) {
+        chunk = std::make_shared<ParsedChunk const>(parseChunk(text));
+    }
+    mUsedChunks.emplace(text.toString(), chunk);
+    return chunk;
+}
+
+void IncrementalParser::parseIncludedFiles(std::vector<Chunk> const& chunks, QString const& directory) {
+    std::set<QString> readFiles;
+    // chunks of the files read in the last round with the directory of the file
+    std::vector<std::pair<std::vector<Chunk> const*, QString>> including{{&chunks, directory}};
+    while(!including.empty()) {
+        std::vector<std::pair<std::vector<Chunk> const*, QString>> included;
+        for(auto const& [fileChunks, fileDirectory]: including) {
+            for(auto const& chunk: *fileChunks) {
+                auto const parsed = parsedChunk(chunk.text);
+                for(auto const& include: parsed->mIncludes) {
+                    auto const fileName = absoluteFileName(include.fileName, fileDirectory);
+                    if(!readFiles.insert(fileName).second) {
+                        continue;
+                    }
+                    if(auto const file = includedFile(fileName)) {
+                        parseNewChunks(file->chunks);
+                        included.emplace_back(&file->chunks, file->directory);
+                    }
+                }
+            }
+        }
+        including = std::move(included);
+    }
+
+    // files that are not included anymore
+    std::erase_if(mIncludedFiles, [&readFiles](auto const& file){
+        return readFiles.find(file.first) == readFiles.end();
+    });
+}
+
+IncrementalParser::IncludedFile const* IncrementalParser::includedFile(QString const& fileName) {
+    QFileInfo const info(fileName);
+    if(!info.isFile()) {
+        mIncludedFiles.erase(fileName);
+        return nullptr;
+    }
+    auto& file = mIncludedFiles[fileName];
+    if(!file.chunks.empty() && file.modified == info.lastModified() && file.size == info.size()) {
+        return &file;
+    }
+    QFile input(fileName);
+    if(!input.open(QIODevice::ReadOnly)) {
+        mIncludedFiles.erase(fileName);
+        return nullptr;
+    }
+    auto const data = input.readAll();
+    file.modified = info.lastModified();
+    file.size = info.size();
+    // a file that is saved without changes keeps its chunks
+    auto const hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    if(file.chunks.empty() || hash != file.hash) {
+        file.hash = hash;
+        file.directory = info.absolutePath();
+        file.text = QString::fromUtf8(data);
+        file.chunks = splitAtSlides(QStringView(file.text));
+    }
+    return &file;
+}
+
+std::optional<ParserError> IncrementalParser::appendIncludedFile(SlideAssembler& assembler, QString const& fileName, int line,
+                                                                 std::vector<QString>& includeStack) {
+    if(std::find(includeStack.begin(), includeStack.end(), fileName) != includeStack.end()) {
+        return ParserError{QString("File %1 includes itself.").arg(fileName), line};
+    }
+    auto const file = includedFile(fileName);
+    if(!file) {
+        return ParserError{QString("Cannot open file %1.").arg(fileName), line};
+    }
+
+    includeStack.push_back(fileName);
+    // the slides of the file are in the line of the \include, errors in the file are reported there
+    auto const includeHandler = [&](Include const& include) {
+        return appendIncludedFile(assembler, absoluteFileName(include.fileName, file->directory), line, includeStack);
+    };
+    for(auto const& chunk: file->chunks) {
+        if(chunk.text.isEmpty()) {
+            continue;
+        }
+        auto const parsed = parsedChunk(chunk.text);
+        if(auto const& error = parsed->mParserError) {
+            return ParserError{QString("%1, line %2: %3").arg(fileName).arg(chunk.line + error->line + 1).arg(error->message), line};
+        }
+        if(!parsed->mPreamble.templateName.isEmpty()) {
+            return ParserError{QString("%1: \\usetemplate is only possible in the presentation.").arg(fileName), line};
+        }
+        if(auto const error = assembler.append(*parsed, line, false, includeHandler)) {
+            return error;
+        }
+    }
+    includeStack.pop_back();
+    return {};
+}
+
+QStringList IncrementalParser::includedFiles() const {
+    QStringList files;
+    for(auto const& file: mIncludedFiles) {
+        files.append(file.first);
+    }
+    return files;
+}
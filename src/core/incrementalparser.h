@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef INCREMENTALPARSER_H
+#define INCREMENTALPARSER_H
+
+#include "parser.h"
+#include "parsecache.h"
+#include "slidesplitter.h"
+#include "slideassembler.h"
+
+#include <QDateTime>
+#include <QThreadPool>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+// Splits the input at the "\slide" commands and parses only the parts whose text
+// changed since the last call. The slides of the unchanged parts are copied from
+// the last result, page numbers and variables are assigned afterwards.
+// New chunks, e.g. all of them after opening a document, are parsed in parallel.
+// A slide with a syntax error keeps its last version without error while the number
+// of slides is unchanged, so that the other slides stay visible.
+// Files included with \include are split and parsed in the same way, they are only
+// read again when their modification time or size changed.
+class IncrementalParser
+{
+public:
+    IncrementalParser() = default;
+
+    ParserOutput parse(QString const& text, QString const& directory);
+    void clear();
+
+    // reads the chunks stored for the document, they are used until the next clear
+    void setCacheFile(QString const& fileName);
+    // stores the chunks of the last successfull parse
+    void saveCache() const;
+
+    // absolute paths of the files included by the last parse
+    QStringList includedFiles() const;
+
+    using Chunk = TextChunk<QStringView>;
+
+private:
+    struct IncludedFile {
+        QDateTime modified;
+        qint64 size = 0;
+        QByteArray hash;
+        QString directory;
+        // the chunks are views into the text
+        QString text;
+        std::vector<Chunk> chunks;
+    };
+
+    // parses the chunks that are in none of the caches on the thread pool
+    void parseNewChunks(std::vector<Chunk> const& chunks);
+    // reads and parses the files included by the chunks and the files included by them
+    void parseIncludedFiles(std::vector<Chunk> const& chunks, QString const& directory);
+    // nullptr if the file cannot be read
+    IncludedFile const* includedFile(QString const& fileName);
+    // appends the slides of the file, line is the line of the \include in the input
+    std::optional<ParserError> appendIncludedFile(SlideAssembler& assembler, QString const& fileName, int line,
+                                                  std::vector<QString>& includeStack);
+    std::shared_ptr<ParsedChunk const> cachedChunk(QStringView text) const;
+    std::shared_ptr<ParsedChunk const> parsedChunk(QStringView text);
+
+private:
+    // looks up the chunks with views into the input, the text is only copied for new chunks
+    struct ChunkHash {
+        using is_transparent = void;
+        size_t operator()(QStringView text) const {
+            return qHash(text);
+        }
+    };
+    using ChunkMap = std::unordered_map<QString, std::shared_ptr<ParsedChunk const>, ChunkHash, std::equal_to<>>;
+
+    // parsed chunks of the last call, the key is the text of the chunk
+    ChunkMap mChunks;
+    ChunkMap mUsedChunks;
+    // chunks of the last successfull run by position, a chunk with an error is replaced by them
+    std::vector<std::shared_ptr<ParsedChunk const>> mLastGoodChunks;
+    // chunks read from the cache file
+    CachedChunks mStoredChunks;
+    QString mCacheFile;
+    QThreadPool mParsePool;
+    // included files by their absolute path
+    std::map<QString, IncludedFile> mIncludedFiles;
+};
+
+#endif // INCREMENTALPARSER_H
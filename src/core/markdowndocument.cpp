@@ -0,0 +1,203 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "markdowndocument.h"
+
+#include "antlr4-runtime.h"
+#include "markdownBaseListener.h"
+#include "markdownLexer.h"
+#include "markdownParser.h"
+#include "twostageparse.h"
+
+#include <QMutex>
+#include <atomic>
+#include <list>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+class MarkdownCompiler: public markdownBaseListener {
+public:
+    void enterText_plain(markdownParser::Text_plainContext *ctx) override {
+        if(!mInFormula) {
+            mParagraph.text.append(QString::fromStdString(ctx->getText()));
+        }
+    }
+
+    void enterText_bold(markdownParser::Text_boldContext *) override {
+        pushSpan(MarkdownDocument::Span::Bold);
+    }
+    void exitText_bold(markdownParser::Text_boldContext *) override {
+        popSpan();
+    }
+
+    void enterText_italic(markdownParser::Text_italicContext *) override {
+        pushSpan(MarkdownDocument::Span::Italic);
+    }
+    void exitText_italic(markdownParser::Text_italicContext *) override {
+        popSpan();
+    }
+
+    void enterText_marked(markdownParser::Text_markedContext *) override {
+        pushSpan(MarkdownDocument::Span::Marked);
+    }
+    void exitText_marked(markdownParser::Text_markedContext *) override {
+        popSpan();
+    }
+
+    void enterLatex(markdownParser::LatexContext *ctx) override {
+        auto text = QString::fromStdString(ctx->getText());
+        text.remove(0, 1);
+        text.remove(text.size()-1, 1);
+        mParagraph.formulas.push_back({int(mParagraph.text.length()), text});
+        mInFormula = true;
+    }
+    void exitLatex(markdownParser::LatexContext *) override {
+        mInFormula = false;
+    }
+
+    void enterLatex_next_line(markdownParser::Latex_next_lineContext *ctx) override {
+        flushItem();
+        auto mathExpression = QString::fromStdString(ctx->getText());
+        mathExpression.remove("$");
+        mDocument.blocks.push_back({MarkdownDocument::Block::Formula, {}, mathExpression});
+        mInFormula = true;
+    }
+    void exitLatex_next_line(markdownParser::Latex_next_lineContext *) override {
+        mInFormula = false;
+    }
+
+    void exitParagraph(markdownParser::ParagraphContext *) override {
+        mDocument.blocks.push_back({mItem.value_or(MarkdownDocument::Block::Paragraph), std::move(mParagraph), {}});
+        mItem.reset();
+        mParagraph = {};
+        mOpenSpans.clear();
+    }
+
+    void enterItem(markdownParser::ItemContext *) override {
+        startItem(MarkdownDocument::Block::Item);
+    }
+    void enterItem_second(markdownParser::Item_secondContext *) override {
+        startItem(MarkdownDocument::Block::ItemSecond);
+    }
+    void enterEnum_item_second(markdownParser::Enum_item_secondContext *ctx) override {
+        if(!ctx->ENUM_SECOND_INTRO()) {
+            return;
+        }
+        startItem(MarkdownDocument::Block::EnumItemSecond);
+        mParagraph.text += QString::fromStdString(ctx->ENUM_SECOND_INTRO()->getText());
+    }
+
+    void exitMarkdown(markdownParser::MarkdownContext *) override {
+        flushItem();
+    }
+
+    MarkdownDocument document() {
+        return std::move(mDocument);
+    }
+
+private:
+    void pushSpan(MarkdownDocument::Span::Format format) {
+        mOpenSpans.push_back(int(mParagraph.spans.size()));
+        mParagraph.spans.push_back({format, int(mParagraph.text.length()), 0});
+    }
+
+    void popSpan() {
+        if(mOpenSpans.empty()) {
+            return;
+        }
+        auto& span = mParagraph.spans[mOpenSpans.back()];
+        span.length = mParagraph.text.length() - span.start;
+        mOpenSpans.pop_back();
+    }
+
+    void startItem(MarkdownDocument::Block::Type type) {
+        flushItem();
+        mItem = type;
+    }
+
+    // an item whose paragraph is missing, e.g. after a syntax error
+    void flushItem() {
+        if(mItem) {
+            mDocument.blocks.push_back({mItem.value(), {}, {}});
+            mItem.reset();
+        }
+    }
+
+private:
+    MarkdownDocument mDocument;
+    MarkdownDocument::Paragraph mParagraph;
+    std::optional<MarkdownDocument::Block::Type> mItem;
+    std::vector<int> mOpenSpans;
+    bool mInFormula = false;
+};
+
+std::atomic<qint64> memoHits = 0;
+std::atomic<qint64> memoMisses = 0;
+
+// the texts of the edited boxes pile up, the least recently used documents are dropped
+constexpr std::size_t maximalMemoSize = 10000;
+
+}
+
+MarkdownDocument compileMarkdown(QString const& text) {
+    std::istringstream str(text.toStdString());
+    antlr4::ANTLRInputStream input(str);
+    markdownLexer lexer(&input);
+    antlr4::CommonTokenStream tokens(&lexer);
+
+    tokens.fill();
+    markdownParser parser(&tokens);
+    antlr4::tree::ParseTree *tree = parseTwoStage(parser, &markdownParser::markdown);
+
+    MarkdownCompiler compiler;
+    antlr4::tree::ParseTreeWalker walker;
+    walker.walk(&compiler, tree);
+    return compiler.document();
+}
+
+std::shared_ptr<MarkdownDocument const> compiledMarkdown(QString const& text) {
+    using Entry = std::pair<QString, std::shared_ptr<MarkdownDocument const>>;
+    static QMutex mutex;
+    // the most recently used document first, the index finds the entries by their text
+    static std::list<Entry> documents;
+    static std::unordered_map<QString, std::list<Entry>::iterator> index;
+    auto const findDocument = [&text]() -> std::shared_ptr<MarkdownDocument const> {
+        auto const found = index.find(text);
+        if(found == index.end()) {
+            return {};
+        }
+        documents.splice(documents.begin(), documents, found->second);
+        return found->second->second;
+    };
+    {
+        QMutexLocker lock(&mutex);
+        if(auto document = findDocument()) {
+            memoHits++;
+            return document;
+        }
+    }
+    memoMisses++;
+    // the grammar needs the newline at the end of the text
+    auto document = std::make_shared<MarkdownDocument const>(compileMarkdown(text + "\n"));
+    QMutexLocker lock(&mutex);
+    // another thread compiled the text in the meantime
+    if(auto compiled = findDocument()) {
+        return compiled;
+    }
+    documents.emplace_front(text, document);
+    index.emplace(text, documents.begin());
+    if(documents.size() > maximalMemoSize) {
+        index.erase(documents.back().first);
+        documents.pop_back();
+    }
+    return document;
+}
+
+MarkdownMemoStatistics markdownMemoStatistics() {
+    return {memoHits.load(), memoMisses.load()};
+}
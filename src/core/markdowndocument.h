@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef MARKDOWNDOCUMENT_H
+#define MARKDOWNDOCUMENT_H
+
+#include <QString>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// The markdown of a text box as it is drawn, independent of the style of the box.
+// It is compiled once for a text and replayed by the MarkdownFormatVisitor on
+// every paint, so that the ANTLR parser is not needed for painting.
+struct MarkdownDocument {
+    struct Span {
+        enum Format {
+            Bold,
+            Italic,
+            Marked
+        };
+        Format format;
+        int start;
+        int length;
+    };
+
+    // inline formula, position is the position in the text of the paragraph
+    struct Formula {
+        int position;
+        QString expression;
+    };
+
+    struct Paragraph {
+        // text without the formulas
+        QString text;
+        // in the order in which they start, nested spans follow the enclosing span
+        std::vector<Span> spans;
+        std::vector<Formula> formulas;
+    };
+
+    struct Block {
+        enum Type {
+            Paragraph,
+            Item,
+            ItemSecond,
+            EnumItemSecond,
+            // formula on a line of its own
+            Formula
+        };
+        Type type;
+        // empty for a formula, an item can miss its paragraph after a syntax error
+        std::optional<MarkdownDocument::Paragraph> paragraph;
+        QString formula;
+    };
+
+    std::vector<Block> blocks;
+};
+
+MarkdownDocument compileMarkdown(QString const& text);
+
+// The compiled documents are memoized by the text of the box with the variables substituted,
+// the newline the grammar needs at the end is appended when the text is compiled.
+std::shared_ptr<MarkdownDocument const> compiledMarkdown(QString const& text);
+
+// counts the texts that were taken from the memo (hits) and compiled (misses) since the start
+struct MarkdownMemoStatistics {
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+MarkdownMemoStatistics markdownMemoStatistics();
+
+#endif // MARKDOWNDOCUMENT_H
@@ -56,8 +56,7 @@ void startLatexConversionProcess(std::string const& formula, ConversionType late
 }
 
 MarkdownFormatVisitor::MarkdownFormatVisitor(QPainter &painter, const QRect &rect, const BoxStyle &style)
-    : markdownBaseListener()
-    , mPainter(painter)
+    : mPainter(painter)
     , mRect(rect)
     , mLineSpacing(painter.fontMetrics().leading() + style.linespacing() * painter.fontMetrics().lineSpacing())
     , mBoxStyle(style)
@@ -65,52 +64,114 @@ MarkdownFormatVisitor::MarkdownFormatVisitor(QPainter &painter, const QRect &rec
 
 }
 
-void MarkdownFormatVisitor::enterText_bold(markdownParser::Text_boldContext * /*ctx*/) {
-    QTextCharFormat format;
-    format.setFontWeight(QFont::Weight::Bold);
-    mCurrentParagraph.mStack.push(mCurrentParagraph.mText.length(), format);
-}
-
-void MarkdownFormatVisitor::exitText_bold(markdownParser::Text_boldContext * /*ctx*/) {
-    auto const end = mCurrentParagraph.mText.length();
-    mCurrentParagraph.mStack.pop(end);
-}
-
-void MarkdownFormatVisitor::enterText_italic(markdownParser::Text_italicContext * /*ctx*/) {
-    QTextCharFormat format;
-    format.setFontItalic(true);
-    mCurrentParagraph.mStack.push(mCurrentParagraph.mText.length(), format);
-}
-
-void MarkdownFormatVisitor::exitText_italic(markdownParser::Text_italicContext * /*ctx*/) {
-    mCurrentParagraph.mStack.pop(mCurrentParagraph.mText.length());
+void MarkdownFormatVisitor::draw(MarkdownDocument const& document) {
+    for(auto const& block: document.blocks) {
+        switch(block.type) {
+        case MarkdownDocument::Block::Paragraph:
+            break;
+        case MarkdownDocument::Block::Item:
+            drawItem();
+            break;
+        case MarkdownDocument::Block::ItemSecond:
+            drawItemSecond();
+            break;
+        case MarkdownDocument::Block::EnumItemSecond:
+            startEnumItemSecond();
+            break;
+        case MarkdownDocument::Block::Formula:
+            drawFormulaLine(block.formula);
+            break;
+        }
+        if(block.paragraph) {
+            drawParagraph(block.paragraph.value());
+        }
+    }
 }
 
-void MarkdownFormatVisitor::enterText_marked(markdownParser::Text_markedContext *) {
-    QTextCharFormat format;
-    format.setForeground(mBoxStyle.markerColor());
-    if(mBoxStyle.markerFontWeight() == FontWeight::bold) {
-        format.setFontWeight(QFont::Weight::Bold);
+QTextCharFormat MarkdownFormatVisitor::spanFormat(MarkdownDocument::Span::Format format) const {
+    QTextCharFormat charFormat;
+    switch(format) {
+    case MarkdownDocument::Span::Bold:
+        charFormat.setFontWeight(QFont::Weight::Bold);
+        break;
+    case MarkdownDocument::Span::Italic:
+        charFormat.setFontItalic(true);
+        break;
+    case MarkdownDocument::Span::Marked:
+        charFormat.setForeground(mBoxStyle.markerColor());
+        if(mBoxStyle.markerFontWeight() == FontWeight::bold) {
+            charFormat.setFontWeight(QFont::Weight::Bold);
+        }
+        break;
     }
-    mCurrentParagraph.mStack.push(mCurrentParagraph.mText.length(), format);
+    return charFormat;
 }
 
-void MarkdownFormatVisitor::exitText_marked(markdownParser::Text_markedContext *) {
-    mCurrentParagraph.mStack.pop(mCurrentParagraph.mText.length());
-}
+void MarkdownFormatVisitor::drawParagraph(MarkdownDocument::Paragraph const& paragraph) {
+    // the text in front of the formulas is inserted, the formulas add their placeholders or errors
+    struct Insertion {
+        int position;
+        int length;
+    };
+    std::vector<Insertion> insertions;
+    auto const paragraphStart = mCurrentParagraph.mText.length();
+    auto position = 0;
+    for(auto const& formula: paragraph.formulas) {
+        mCurrentParagraph.mText.append(paragraph.text.mid(position, formula.position - position));
+        position = formula.position;
+        auto const length = mCurrentParagraph.mText.length();
+        addFormula(formula.expression);
+        insertions.push_back({formula.position, int(mCurrentParagraph.mText.length() - length)});
+    }
+    mCurrentParagraph.mText.append(paragraph.text.mid(position));
+
+    // spans never contain a formula, a formula at the start of a span is in front of it
+    auto const shifted = [&insertions, paragraphStart](int position, bool atStart) {
+        auto result = paragraphStart + position;
+        for(auto const& insertion: insertions) {
+            if(insertion.position < position || (atStart && insertion.position == position)) {
+                result += insertion.length;
+            }
+        }
+        return result;
+    };
+    for(auto const& span: paragraph.spans) {
+        auto const start = shifted(span.start, true);
+        auto const end = shifted(span.start + span.length, false);
+        mCurrentParagraph.mStack.push({start, end - start, spanFormat(span.format)});
+    }
 
-void MarkdownFormatVisitor::enterText_plain(markdownParser::Text_plainContext *ctx) {
-    if(mDrawPlainText) {
-        mCurrentParagraph.mText.append(QString::fromStdString(ctx->getText()));
+    if(mCurrentParagraph.mText.isEmpty()) {
+        newLine();
+        mStartOfLine.setX(0);
+        return;
     }
+    QTextLayout textLayout(mCurrentParagraph.mText);
+    textLayout.setTextOption(QTextOption(mBoxStyle.alignment()));
+    textLayout.setFont(mPainter.font());
+    textLayout.setCacheEnabled(true);
+    textLayout.setFormats(mCurrentParagraph.mStack.mVector);
+    textLayout.beginLayout();
+    while (1) {
+        QTextLine line = textLayout.createLine();
+        if (!line.isValid()){
+            break;
+        }
+        line.setLineWidth(mRect.width() - mStartOfLine.x());
+        line.setPosition(QPointF(mStartOfLine.x(), mStartOfLine.y()));
+        mTextBoundings.lineBoundingRects.push_back(line.naturalTextRect());
+        newLine();
+    }
+    textLayout.endLayout();
+    textLayout.draw(&mPainter, mRect.topLeft());
+    mStartOfLine.setX(0);
+    mCurrentParagraph.mStack.clear();
+    mCurrentParagraph.mText = "";
+    drawFormulasInParagraph(textLayout);
 }
 
-void MarkdownFormatVisitor::enterLatex(markdownParser::LatexContext *ctx) {
-    int start = mCurrentParagraph.mText.length();
-    auto text = QString::fromStdString(ctx->getText());
-    text.remove(0, 1);
-    text.remove(text.size()-1, 1);
-    auto const svgEntry = loadSvg(text, start);
+void MarkdownFormatVisitor::addFormula(QString const& mathExpression) {
+    auto const svgEntry = loadSvg(mathExpression, mCurrentParagraph.mText.length());
     if (!svgEntry.mSvg) {
         return;
     }
@@ -121,17 +182,9 @@ void MarkdownFormatVisitor::enterLatex(markdownParser::LatexContext *ctx) {
     QTextLayout::FormatRange formatrange{mCurrentParagraph.mText.length(), 2, format};
     mCurrentParagraph.mText.append(". ");
     mCurrentParagraph.mStack.push(formatrange);
-    mDrawPlainText = false;
-}
-
-void MarkdownFormatVisitor::exitLatex(markdownParser::LatexContext *) {
-    mDrawPlainText = true;
 }
 
-void MarkdownFormatVisitor::enterLatex_next_line(markdownParser::Latex_next_lineContext *ctx) {
-    auto mathExpression = QString::fromStdString(ctx->getText());
-    mathExpression.remove("$");
-    qInfo() << "latex next line" << mathExpression;
+void MarkdownFormatVisitor::drawFormulaLine(QString const& mathExpression) {
     auto const equation = cacheManager().getCachedImage(latexInput(mathExpression));
     switch(equation.status){
     case SvgStatus::Error: {
@@ -157,44 +210,9 @@ void MarkdownFormatVisitor::enterLatex_next_line(markdownParser::Latex_next_line
         addYToPosition(1.2 * mLineSpacing);
         break;
     }
-    mDrawPlainText = false;
-}
-
-void MarkdownFormatVisitor::exitLatex_next_line(markdownParser::Latex_next_lineContext *) {
-    mDrawPlainText = true;
-}
-
-void MarkdownFormatVisitor::exitParagraph(markdownParser::ParagraphContext * ctx) {
-    if(mCurrentParagraph.mText.isEmpty()) {
-        newLine();
-        mStartOfLine.setX(0);
-        return;
-    }
-    QTextLayout textLayout(mCurrentParagraph.mText);
-    textLayout.setTextOption(QTextOption(mBoxStyle.alignment()));
-    textLayout.setFont(mPainter.font());
-    textLayout.setCacheEnabled(true);
-    textLayout.setFormats(mCurrentParagraph.mStack.mVector);
-    textLayout.beginLayout();
-    while (1) {
-        QTextLine line = textLayout.createLine();
-        if (!line.isValid()){
-            break;
-        }
-        line.setLineWidth(mRect.width() - mStartOfLine.x());
-        line.setPosition(QPointF(mStartOfLine.x(), mStartOfLine.y()));
-        mTextBoundings.lineBoundingRects.push_back(line.naturalTextRect());
-        newLine();
-    }
-    textLayout.endLayout();
-    textLayout.draw(&mPainter, mRect.topLeft());
-    mStartOfLine.setX(0);
-    mCurrentParagraph.mStack.clear();
-    mCurrentParagraph.mText = "";
-    drawFormulasInParagraph(textLayout);
 }
 
-void MarkdownFormatVisitor::enterItem(markdownParser::ItemContext *) {
+void MarkdownFormatVisitor::drawItem() {
     addYToPosition(mPainter.fontMetrics().lineSpacing() * 0.3);
     mStartOfLine.setX(mPainter.fontMetrics().xHeight() * 3);
     auto const markerSize = mPainter.fontMetrics().xHeight() * 0.3;
@@ -204,7 +222,7 @@ void MarkdownFormatVisitor::enterItem(markdownParser::ItemContext *) {
     addXToPosition(2 * markerSize + mPainter.fontMetrics().horizontalAdvance(" "));
 }
 
-void MarkdownFormatVisitor::enterItem_second(markdownParser::Item_secondContext * /*ctx*/) {
+void MarkdownFormatVisitor::drawItemSecond() {
     addYToPosition(mPainter.fontMetrics().lineSpacing() * 0.15);
     mStartOfLine.setX(mPainter.fontMetrics().xHeight() * 5);
     auto const markerSize = mPainter.fontMetrics().xHeight() * 0.25;
@@ -214,9 +232,7 @@ void MarkdownFormatVisitor::enterItem_second(markdownParser::Item_secondContext
     addXToPosition(2 * markerSize + mPainter.fontMetrics().horizontalAdvance(" "));
 }
 
-void MarkdownFormatVisitor::enterEnum_item_second(markdownParser::Enum_item_secondContext *ctx) {
-    if(!ctx->ENUM_SECOND_INTRO()) {return;}
-    mCurrentParagraph.mText += QString::fromStdString(ctx->ENUM_SECOND_INTRO()->getText());
+void MarkdownFormatVisitor::startEnumItemSecond() {
     addYToPosition(mPainter.fontMetrics().lineSpacing() * 0.15);
     mStartOfLine.setX(mPainter.fontMetrics().xHeight() * 5);
 }
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include "markdownBaseListener.h"
+#include "markdowndocument.h"
 #include "box.h"
 #include "textbox.h"
 #include "latexcachemanager.h"
@@ -44,37 +44,26 @@ struct MapSvg{
 };
 
 
-class MarkdownFormatVisitor: public markdownBaseListener {
+// Draws a compiled markdown document into the rect of a box.
+class MarkdownFormatVisitor {
 public:
     MarkdownFormatVisitor(QPainter& painter, QRect const& rect, BoxStyle const& style);
 
-    void enterText_plain(markdownParser::Text_plainContext *ctx) override;
-
-    void enterText_bold(markdownParser::Text_boldContext * /*ctx*/) override;
-    void exitText_bold(markdownParser::Text_boldContext * /*ctx*/) override;
-
-    void enterText_italic(markdownParser::Text_italicContext * ctx) override;
-    void exitText_italic(markdownParser::Text_italicContext * /*ctx*/) override;
-
-    void enterText_marked(markdownParser::Text_markedContext * /*ctx*/) override;
-    void exitText_marked(markdownParser::Text_markedContext * /*ctx*/) override;
-
-    void enterLatex(markdownParser::LatexContext *ctx) override;
-    void exitLatex(markdownParser::LatexContext *ctx) override;
-    void enterLatex_next_line(markdownParser::Latex_next_lineContext *ctx) override;
-    void exitLatex_next_line(markdownParser::Latex_next_lineContext *ctx) override;
-
-    void exitParagraph(markdownParser::ParagraphContext * /*ctx*/) override;
-
-    void enterItem(markdownParser::ItemContext * /*ctx*/) override;
-    void enterItem_second(markdownParser::Item_secondContext * /*ctx*/) override;
-    void enterEnum_item_second(markdownParser::Enum_item_secondContext *ctx) override;
+    void draw(MarkdownDocument const& document);
 
     TextBoundings textBoundings() const;
 
     void setLatexConversionFlags(ConversionType latexConversionType);
 
 private:
+    void drawParagraph(MarkdownDocument::Paragraph const& paragraph);
+    void addFormula(QString const& mathExpression);
+    void drawFormulaLine(QString const& mathExpression);
+    void drawItem();
+    void drawItemSecond();
+    void startEnumItemSecond();
+    QTextCharFormat spanFormat(MarkdownDocument::Span::Format format) const;
+
     void addXToPosition(qreal dx);
     void addYToPosition(qreal dy);
     void newLine();
@@ -90,7 +79,6 @@ private:
     } mCurrentParagraph;
     QPointF mStartOfLine;
     double const mLineSpacing;
-    bool mDrawPlainText = true;
     BoxStyle mBoxStyle;
     std::vector<MapSvg> mMapSvgs;
 
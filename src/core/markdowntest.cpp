@@ -9,6 +9,7 @@
 #include "markdownParser.h"
 #include "markdownLexer.h"
 #include "markdownerrorlistener.h"
+#include "markdowndocument.h"
 
 #include<QtDebug>
 #include<QBuffer>
@@ -37,6 +38,40 @@ void MarkdownTest::testMarkdown() {
     QVERIFY(errorListener.success());
 }
 
+void MarkdownTest::testCompile() {
+    auto const document = compileMarkdown("a **b __c__** $\\pi$ d\n* item\n    1. sub\n$$x$$\n");
+    QCOMPARE(int(document.blocks.size()), 4);
+
+    auto const& paragraph = document.blocks[0].paragraph.value();
+    QCOMPARE(document.blocks[0].type, MarkdownDocument::Block::Paragraph);
+    QCOMPARE(paragraph.text, QString("a b c  d"));
+    QCOMPARE(int(paragraph.spans.size()), 2);
+    QCOMPARE(paragraph.spans[0].format, MarkdownDocument::Span::Bold);
+    QCOMPARE(paragraph.spans[0].start, 2);
+    QCOMPARE(paragraph.spans[0].length, 3);
+    QCOMPARE(paragraph.spans[1].format, MarkdownDocument::Span::Italic);
+    QCOMPARE(paragraph.spans[1].start, 4);
+    QCOMPARE(paragraph.spans[1].length, 1);
+    QCOMPARE(int(paragraph.formulas.size()), 1);
+    QCOMPARE(paragraph.formulas[0].position, 6);
+    QCOMPARE(paragraph.formulas[0].expression, QString("\\pi"));
+
+    QCOMPARE(document.blocks[1].type, MarkdownDocument::Block::Item);
+    QCOMPARE(document.blocks[1].paragraph->text, QString("item"));
+    QCOMPARE(document.blocks[2].type, MarkdownDocument::Block::EnumItemSecond);
+    QCOMPARE(document.blocks[2].paragraph->text, QString("\n    1. sub"));
+    QCOMPARE(document.blocks[3].type, MarkdownDocument::Block::Formula);
+    QCOMPARE(document.blocks[3].formula, QString("x"));
+
+    // the same text is compiled once
+    auto const before = markdownMemoStatistics();
+    auto const compiled = compiledMarkdown("compiled **once**");
+    QVERIFY(compiledMarkdown("compiled **once**") == compiled);
+    QCOMPARE(int(compiled->blocks.size()), 1);
+    QCOMPARE(markdownMemoStatistics().misses, before.misses + 1);
+    QCOMPARE(markdownMemoStatistics().hits, before.hits + 1);
+}
+
 void MarkdownTest::testMarkdown_data(){
     QTest::addColumn<QString>("inputText");
     QTest::newRow("word") << "Hello\n";
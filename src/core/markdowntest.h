@@ -15,6 +15,7 @@ class MarkdownTest : public QObject
 private Q_SLOTS:
     void testMarkdown();
     void testMarkdown_data();
+    void testCompile();
 };
 
 #endif // MARKDOWNTEST_H
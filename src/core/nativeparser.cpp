@@ -0,0 +1,350 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "nativeparser.h"
+
+#include <algorithm>
+
+namespace {
+
+// characters of the WORD token
+bool isWordCharacter(QChar character) {
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z')
+            || (character >= '0' && character <= '9') || QStringView(u"-._#+/()").contains(character);
+}
+
+// characters of the SPECIAL_CHARACTER token, '#' and '+' belong to both
+bool isSpecialCharacter(QChar character) {
+    if(character == '#' || character == '+') {
+        return true;
+    }
+    return !isWordCharacter(character) && !QStringView(u" \\;:\n[]").contains(character);
+}
+
+int lengthOfRun(QStringView text, int start, bool (*belongsToRun)(QChar)) {
+    int end = start;
+    while(end < text.size() && belongsToRun(text[end])) {
+        end++;
+    }
+    return end - start;
+}
+
+QString const commandFormatMessage = "A command must be in the form \\command [property list] paragraph.";
+
+}
+
+NativeParser::NativeParser(QStringView text, SlideListBuilder& builder)
+    : mText(text)
+    , mBuilder(builder)
+    , mLastClosingBracket(int(text.lastIndexOf(u"\\}")))
+{
+}
+
+void NativeParser::parse() {
+    if(peek().type != TokenType::Backslash) {
+        throw ParserError{"Missing Input or '\\'?", mPosition.line};
+    }
+    // like "potato: box+" the input ends at the first box that is not followed by a command
+    while(peek().type == TokenType::Backslash) {
+        parseBox();
+    }
+    mBuilder.finish();
+}
+
+NativeParser::Token NativeParser::peek() const {
+    auto const index = mPosition.index;
+    if(index >= int(mText.size())) {
+        return {TokenType::End, index, index};
+    }
+    auto const character = mText[index];
+    auto const singleCharacter = [index](TokenType type) {
+        return Token{type, index, index + 1};
+    };
+    switch(character.unicode()) {
+    case ' ':
+        return singleCharacter(TokenType::Space);
+    case '\n':
+        return singleCharacter(TokenType::Newline);
+    case ':':
+        return singleCharacter(TokenType::Colon);
+    case ';':
+        return singleCharacter(TokenType::Semicolon);
+    case '[':
+        return singleCharacter(TokenType::OpenBracket);
+    case ']':
+        return singleCharacter(TokenType::CloseBracket);
+    case '\\':
+        if(index + 1 < int(mText.size()) && mText[index + 1] == '{' && mLastClosingBracket >= index + 2) {
+            auto const closingBracket = int(mText.indexOf(u"\\}", index + 2));
+            return {TokenType::TextInBracket, index, closingBracket + 2};
+        }
+        return singleCharacter(TokenType::Backslash);
+    default:
+        break;
+    }
+    // the lexer takes the longer match, SPECIAL_CHARACTER wins if both are equally long
+    auto const wordLength = lengthOfRun(mText, index, isWordCharacter);
+    auto const specialLength = lengthOfRun(mText, index, isSpecialCharacter);
+    if(wordLength > specialLength) {
+        return {TokenType::Word, index, index + wordLength};
+    }
+    return {TokenType::SpecialCharacter, index, index + specialLength};
+}
+
+void NativeParser::advance(Token const& token) {
+    if(token.type == TokenType::Newline) {
+        mPosition.line++;
+    }
+    else if(token.type == TokenType::TextInBracket) {
+        auto const textInBracket = text(token);
+        mPosition.line += int(std::count(textInBracket.begin(), textInBracket.end(), '\n'));
+    }
+    mPosition.index = token.end;
+}
+
+QStringView NativeParser::text(Token const& token) const {
+    return mText.mid(token.start, token.end - token.start);
+}
+
+void NativeParser::skipWhitespace() {
+    auto token = peek();
+    while(token.type == TokenType::Space || token.type == TokenType::Newline) {
+        advance(token);
+        token = peek();
+    }
+}
+
+void NativeParser::parseBox() {
+    auto const line = mPosition.line;
+    parseCommand();
+    auto const afterCommand = mPosition;
+    skipWhitespace();
+    if(peek().type == TokenType::OpenBracket && propertyListBeforeParagraph(afterCommand)) {
+        for(auto const& property: readPropertyList()) {
+            mBuilder.addProperty(property.name, property.value, property.line);
+        }
+    }
+    else {
+        mPosition = afterCommand;
+    }
+    if(parseParagraph()) {
+        parseBoxEnd();
+    }
+    mBuilder.finishBox(line);
+}
+
+void NativeParser::parseCommand() {
+    advance(peek());
+    auto const word = peek();
+    if(word.type != TokenType::Word) {
+        commandError(word);
+    }
+    mBuilder.setCommand(text(word));
+    advance(word);
+}
+
+// Decides "command ws*? property_list? paragraph" at a '['. Behind spaces the
+// bracket is the start of a text like "\title [not a property]", ANTLR only
+// chooses the property list if the text fails at a following text in brackets.
+bool NativeParser::propertyListBeforeParagraph(Position afterCommand) {
+    if(mPosition.index == afterCommand.index || mText[mPosition.index - 1] == '\n') {
+        return true;
+    }
+    auto const bracket = mPosition;
+    bool textInBracketFollows = false;
+    try {
+        readPropertyList();
+        skipWhitespace();
+        textInBracketFollows = peek().type == TokenType::TextInBracket;
+    }  catch (ParserError) {
+    }
+    mPosition = bracket;
+    return textInBracketFollows;
+}
+
+std::vector<NativeParser::Property> NativeParser::readPropertyList() {
+    std::vector<Property> properties;
+    advance(peek());
+    if(peek().type == TokenType::CloseBracket) {
+        advance(peek());
+        return properties;
+    }
+    while(true) {
+        properties.push_back(readPropertyEntry());
+        auto const token = peek();
+        if(token.type == TokenType::CloseBracket) {
+            advance(token);
+            return properties;
+        }
+        if(token.type != TokenType::Semicolon) {
+            propertyError(token, false);
+        }
+        advance(token);
+        // the list may end with a semicolon
+        auto const entryStart = mPosition;
+        skipWhitespace();
+        if(peek().type == TokenType::CloseBracket) {
+            advance(peek());
+            return properties;
+        }
+        mPosition = entryStart;
+    }
+}
+
+NativeParser::Property NativeParser::readPropertyEntry() {
+    // the entry starts with the whitespace in front of the property
+    auto const line = mPosition.line;
+    skipWhitespace();
+    auto const property = peek();
+    if(property.type != TokenType::Word) {
+        propertyError(property, true);
+    }
+    advance(property);
+    skipWhitespace();
+    if(peek().type != TokenType::Colon) {
+        propertyError(peek(), true);
+    }
+    advance(peek());
+    skipWhitespace();
+
+    // value: WORD (WORD | ' ')* WORD
+    auto token = peek();
+    if(token.type != TokenType::Word) {
+        propertyError(token, true);
+    }
+    auto const valueStart = token.start;
+    auto valueEnd = token.end;
+    while(token.type == TokenType::Word || token.type == TokenType::Space) {
+        if(token.type == TokenType::Word) {
+            valueEnd = token.end;
+        }
+        advance(token);
+        token = peek();
+    }
+    skipWhitespace();
+    return {text(property), mText.mid(valueStart, valueEnd - valueStart), line};
+}
+
+bool NativeParser::parseParagraph() {
+    auto const start = mPosition;
+    skipWhitespace();
+    auto const next = peek();
+    switch(next.type) {
+    case TokenType::TextInBracket:
+        mBuilder.setTextInBracket(text(next));
+        advance(next);
+        return true;
+    case TokenType::Word:
+    case TokenType::SpecialCharacter:
+    case TokenType::Colon:
+    case TokenType::Semicolon:
+    case TokenType::CloseBracket:
+        parseText();
+        return true;
+    case TokenType::OpenBracket:
+    case TokenType::Backslash:
+        // a line of text cannot start with '[' or '\', but the space in front of them can start it
+        if(mPosition.index > start.index && mText[mPosition.index - 1] == ' ') {
+            mPosition.index--;
+            parseText();
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+    // the whitespace after the command is the end of the box,
+    // lines only containing spaces would be an empty text
+    if(next.type == TokenType::End || (mPosition.index > start.index && mText[mPosition.index - 1] == '\n')) {
+        return false;
+    }
+    mPosition = start;
+    return true;
+}
+
+void NativeParser::parseText() {
+    auto const start = mPosition.index;
+    int end = start;
+    while(true) {
+        auto token = peek();
+        while(token.type != TokenType::Newline && token.type != TokenType::End && token.type != TokenType::TextInBracket) {
+            advance(token);
+            token = peek();
+        }
+        end = mPosition.index;
+        if(token.type != TokenType::Newline) {
+            break;
+        }
+        // the text continues if the next non empty line does not start with '\', '[' or '\{'
+        auto const endOfLine = mPosition;
+        while(token.type == TokenType::Newline) {
+            advance(token);
+            token = peek();
+        }
+        if(token.type == TokenType::End || token.type == TokenType::Backslash
+                || token.type == TokenType::OpenBracket || token.type == TokenType::TextInBracket) {
+            mPosition = endOfLine;
+            break;
+        }
+    }
+    mBuilder.setText(mText.mid(start, end - start));
+}
+
+void NativeParser::parseBoxEnd() {
+    // ' '* '\n'+ | EOF
+    auto token = peek();
+    if(token.type == TokenType::End) {
+        return;
+    }
+    while(token.type == TokenType::Space) {
+        advance(token);
+        token = peek();
+    }
+    if(token.type != TokenType::Newline) {
+        auto message = commandFormatMessage;
+        if(text(token) == u"\\") {
+            message.append(" Missing newline for command?");
+        }
+        if(text(token) == u"}") {
+            message.append(" Missing '\\}'?");
+        }
+        throw ParserError{message, mPosition.line};
+    }
+    while(token.type == TokenType::Newline) {
+        advance(token);
+        token = peek();
+    }
+}
+
+void NativeParser::commandError(Token const& token) const {
+    auto message = commandFormatMessage;
+    auto const tokenText = text(token);
+    if(tokenText == u"\\") {
+        message.append(" Missing newline for command?");
+    }
+    if(tokenText == u" ") {
+        message.append(" Missing command? Space is permited behind '\\'.");
+    }
+    if(tokenText == u"{") {
+        message.append(" Missing '\\}'?");
+    }
+    throw ParserError{message, mPosition.line};
+}
+
+void NativeParser::propertyError(Token const& token, bool inEntry) const {
+    auto message = QString(" Properties must be in the format [property: value; property: value; etc].");
+    auto const tokenText = text(token);
+    if(inEntry && tokenText == u"\\") {
+        message.append(" Missing ']' or ':' value?");
+    }
+    if(!inEntry && tokenText == u"\\") {
+        message.append(" Missing value?");
+    }
+    if(!inEntry && tokenText == u":") {
+        message.append(" Missing property?");
+    }
+    throw ParserError{message, mPosition.line};
+}
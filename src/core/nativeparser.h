@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef NATIVEPARSER_H
+#define NATIVEPARSER_H
+
+#include "slidelistbuilder.h"
+
+#include <QString>
+#include <vector>
+
+// Recursive descent parser for the grammar in potato.g4. Reads the input in one
+// pass and hands views of it directly to the builder, without token stream
+// or parse tree. Where the grammar is ambiguous it decides like ANTLR does.
+class NativeParser
+{
+public:
+    NativeParser(QStringView text, SlideListBuilder& builder);
+
+    // throws ParserError
+    void parse();
+
+private:
+    // the tokens of potato.g4
+    enum class TokenType {
+        End,
+        Space,
+        Newline,
+        Colon,
+        Semicolon,
+        OpenBracket,
+        CloseBracket,
+        Backslash,
+        Word,
+        SpecialCharacter,
+        TextInBracket
+    };
+
+    struct Token {
+        TokenType type;
+        int start;
+        int end;
+    };
+
+    struct Position {
+        int index;
+        int line;
+    };
+
+    struct Property {
+        QStringView name;
+        QStringView value;
+        int line;
+    };
+
+    Token peek() const;
+    void advance(Token const& token);
+    QStringView text(Token const& token) const;
+    void skipWhitespace();
+
+    void parseBox();
+    void parseCommand();
+    bool propertyListBeforeParagraph(Position afterCommand);
+    std::vector<Property> readPropertyList();
+    Property readPropertyEntry();
+    // returns false if the paragraph already ended the box
+    bool parseParagraph();
+    void parseText();
+    void parseBoxEnd();
+
+    [[noreturn]] void commandError(Token const& token) const;
+    [[noreturn]] void propertyError(Token const& token, bool inEntry) const;
+
+private:
+    QStringView mText;
+    SlideListBuilder& mBuilder;
+    Position mPosition{0, 0};
+    // \{ only starts a text in brackets if a \} follows
+    int mLastClosingBracket;
+};
+
+#endif // NATIVEPARSER_H
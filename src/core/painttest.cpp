@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "painttest.h"
+
+#include "markdowndocument.h"
+#include "parser.h"
+#include "presentationdata.h"
+#include "sliderenderer.h"
+#include "template.h"
+
+#include <QImage>
+#include <QPainter>
+
+QTEST_MAIN(PaintTest)
+
+void PaintTest::testTemplateBoxes() {
+    auto templateOutput = generateSlides(QString("\\slide[defineclass: default] default\n"
+                                                 "\\text[class: pagenumber] Page %{pagenumber}\n"), {}, true);
+    QVERIFY(templateOutput.successfull());
+    auto const presentationTemplate = std::make_shared<Template>();
+    presentationTemplate->setData(templateOutput.takeSlideList());
+
+    auto output = generateSlides(QString("\\slide one\n\\text first\n\\slide two\n\\text second\n"), {});
+    QVERIFY(output.successfull());
+    PresentationData data(output.takeSlideList(), presentationTemplate);
+    data.applyConfiguration(ConfigBoxes());
+    auto const& slides = data.slides().vector;
+    // the slides share the box of the template, it draws another page number on each of them
+    QCOMPARE(slides[0]->templateBoxes()[0], slides[1]->templateBoxes()[0]);
+
+    QImage image(1600, 900, QImage::Format_ARGB32);
+    QPainter painter(&image);
+    SlideRenderer const renderer(painter);
+    auto const paintSlides = [&slides, &renderer](){
+        for(auto const& slide: slides) {
+            renderer.paintSlide(slide);
+        }
+    };
+    auto const before = markdownMemoStatistics();
+    paintSlides();
+    QCOMPARE(markdownMemoStatistics().misses - before.misses, qint64(4));
+
+    // painting the slides again, e.g. for the export after the preview, compiles nothing
+    // only the shared box of the template looks up its other text on each slide
+    paintSlides();
+    paintSlides();
+    QCOMPARE(markdownMemoStatistics().misses - before.misses, qint64(4));
+    QCOMPARE(markdownMemoStatistics().hits - before.hits, qint64(4));
+}
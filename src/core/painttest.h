@@ -0,0 +1,19 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef PAINTTEST_H
+#define PAINTTEST_H
+
+#include <QtTest/QTest>
+
+class PaintTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTemplateBoxes();
+};
+
+#endif // PAINTTEST_H
@@ -0,0 +1,298 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "parsecache.h"
+#include "imagebox.h"
+#include "markdowntextbox.h"
+#include "plaintextbox.h"
+#include "codebox.h"
+#include "geometrybox.h"
+#include "latexbox.h"
+#include "tableofcontentsbox.h"
+#include "sectionpreviewbox.h"
+#include "version.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <typeinfo>
+
+namespace {
+
+QString const magic = "PotatoParseCache";
+// increase when the format or the output of the parser changes
+qint32 const cacheVersion = 4;
+
+enum class BoxType : quint8 {
+    MarkdownText,
+    Image,
+    Code,
+    PlainText,
+    Geometry,
+    LaTeX,
+    TableOfContents,
+    SectionPreview
+};
+
+std::optional<BoxType> boxType(Box const& box) {
+    auto const& type = typeid(box);
+    if(type == typeid(MarkdownTextBox)) {
+        return BoxType::MarkdownText;
+    }
+    if(type == typeid(ImageBox)) {
+        return BoxType::Image;
+    }
+    if(type == typeid(CodeBox)) {
+        return BoxType::Code;
+    }
+    if(type == typeid(PlainTextBox)) {
+        return BoxType::PlainText;
+    }
+    if(type == typeid(GeometryBox)) {
+        return BoxType::Geometry;
+    }
+    if(type == typeid(LaTeXBox)) {
+        return BoxType::LaTeX;
+    }
+    if(type == typeid(TableofContentsBox)) {
+        return BoxType::TableOfContents;
+    }
+    if(type == typeid(SectionPreviewBox)) {
+        return BoxType::SectionPreview;
+    }
+    return {};
+}
+
+Box::Ptr createBox(BoxType type) {
+    switch(type) {
+    case BoxType::MarkdownText:
+        return std::make_shared<MarkdownTextBox>();
+    case BoxType::Image:
+        return std::make_shared<ImageBox>();
+    case BoxType::Code:
+        return std::make_shared<CodeBox>();
+    case BoxType::PlainText:
+        return std::make_shared<PlainTextBox>();
+    case BoxType::Geometry:
+        return std::make_shared<GeometryBox>();
+    case BoxType::LaTeX:
+        return std::make_shared<LaTeXBox>();
+    case BoxType::TableOfContents:
+        return std::make_shared<TableofContentsBox>();
+    case BoxType::SectionPreview:
+        return std::make_shared<SectionPreviewBox>();
+    }
+    return {};
+}
+
+void writeOptional(QDataStream& stream, std::optional<QString> const& value) {
+    stream << value.has_value() << value.value_or(QString());
+}
+
+std::optional<QString> readOptional(QDataStream& stream) {
+    bool hasValue;
+    QString value;
+    stream >> hasValue >> value;
+    if(!hasValue) {
+        return {};
+    }
+    return value;
+}
+
+// only writes what the parser sets
+bool writeBox(QDataStream& stream, Box const& box) {
+    auto const type = boxType(box);
+    if(!type) {
+        return false;
+    }
+    stream << quint8(type.value());
+    stream << box.style().mId << box.style().mLine;
+    writeOptional(stream, box.style().mConfigId);
+    writeOptional(stream, box.style().mDefineclass);
+    writeOptional(stream, box.style().mText);
+    stream << qint32(box.pauseCounter().mDisplayMode) << qint32(box.pauseCounter().mCount);
+    stream << quint32(box.properties().size());
+    for(auto const& [property, entry]: box.properties()) {
+        stream << propertyName(property) << entry.mValue << qint32(entry.mLine);
+    }
+    return true;
+}
+
+Box::Ptr readBox(QDataStream& stream) {
+    quint8 type;
+    stream >> type;
+    if(type > quint8(BoxType::SectionPreview)) {
+        return {};
+    }
+    auto box = createBox(BoxType(type));
+    stream >> box->style().mId >> box->style().mLine;
+    box->style().mConfigId = readOptional(stream);
+    box->style().mDefineclass = readOptional(stream);
+    box->style().mText = readOptional(stream);
+    qint32 pauseMode, pauseCount;
+    stream >> pauseMode >> pauseCount;
+    box->setPauseMode(PauseDisplayMode(pauseMode));
+    box->setPauseCounter(pauseCount);
+    quint32 numberProperties;
+    stream >> numberProperties;
+    for(quint32 i = 0; i < numberProperties && stream.status() == QDataStream::Ok; i++) {
+        QString property;
+        PropertyEntry entry;
+        qint32 line;
+        stream >> property >> entry.mValue >> line;
+        entry.mLine = line;
+        // the names are stored, so that the cache does not depend on the order of PropertyId
+        if(auto const id = propertyId(property)) {
+            box->setProperty(id.value(), entry);
+        }
+    }
+    return box;
+}
+
+bool writeChunk(QDataStream& stream, ParsedChunk const& chunk) {
+    stream << chunk.mPreamble.templateName << qint32(chunk.mPreamble.line);
+    stream << quint32(chunk.mVariableAssignments.size());
+    for(auto const& assignment: chunk.mVariableAssignments) {
+        stream << assignment.name << assignment.value;
+    }
+    stream << quint32(chunk.mIncludes.size());
+    for(auto const& include: chunk.mIncludes) {
+        stream << include.fileName << qint32(include.line) << qint32(include.assignmentsBefore);
+    }
+    stream << quint32(chunk.mSlideList.vector.size());
+    for(auto const& slide: chunk.mSlideList.vector) {
+        stream << slide->id() << qint32(slide->line()) << slide->slideClass() << slide->definesClass();
+        stream << quint32(slide->boxes().size());
+        for(auto const& box: slide->boxes()) {
+            if(!writeBox(stream, *box)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<ParsedChunk const> readChunk(QDataStream& stream) {
+    auto chunk = std::make_shared<ParsedChunk>();
+    qint32 preambleLine;
+    stream >> chunk->mPreamble.templateName >> preambleLine;
+    chunk->mPreamble.line = preambleLine;
+    quint32 numberAssignments;
+    stream >> numberAssignments;
+    for(quint32 i = 0; i < numberAssignments && stream.status() == QDataStream::Ok; i++) {
+        VariableAssignment assignment;
+        stream >> assignment.name >> assignment.value;
+        chunk->mVariableAssignments.push_back(assignment);
+    }
+    quint32 numberIncludes;
+    stream >> numberIncludes;
+    for(quint32 i = 0; i < numberIncludes && stream.status() == QDataStream::Ok; i++) {
+        Include include;
+        qint32 line;
+        qint32 assignmentsBefore;
+        stream >> include.fileName >> line >> assignmentsBefore;
+        include.line = line;
+        include.assignmentsBefore = assignmentsBefore;
+        chunk->mIncludes.push_back(include);
+    }
+    quint32 numberSlides;
+    stream >> numberSlides;
+    for(quint32 i = 0; i < numberSlides && stream.status() == QDataStream::Ok; i++) {
+        QString id, slideClass, definesClass;
+        qint32 line;
+        stream >> id >> line >> slideClass >> definesClass;
+        auto slide = std::make_shared<Slide>(id, line);
+        slide->setSlideClass(slideClass);
+        slide->setDefinesClass(definesClass);
+        quint32 numberBoxes;
+        stream >> numberBoxes;
+        for(quint32 j = 0; j < numberBoxes && stream.status() == QDataStream::Ok; j++) {
+            auto const box = readBox(stream);
+            if(!box) {
+                return {};
+            }
+            slide->appendBox(box);
+        }
+        chunk->mSlideList.appendSlide(slide);
+    }
+    return chunk;
+}
+
+}
+
+QString parseCacheFileName(QString const& documentPath) {
+    auto const hash = QCryptographicHash::hash(documentPath.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/parser/" + hash + ".cache";
+}
+
+QByteArray parseCacheKey(QStringView text) {
+    return QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1);
+}
+
+CachedChunks readParseCache(QString const& fileName) {
+    auto file = QFile(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    QString fileMagic, version;
+    qint32 fileCacheVersion;
+    stream >> fileMagic >> fileCacheVersion >> version;
+    if(fileMagic != magic || fileCacheVersion != cacheVersion || version != PROJECT_VER) {
+        return {};
+    }
+
+    CachedChunks chunks;
+    quint32 numberChunks;
+    stream >> numberChunks;
+    for(quint32 i = 0; i < numberChunks && stream.status() == QDataStream::Ok; i++) {
+        QByteArray key;
+        stream >> key;
+        auto const chunk = readChunk(stream);
+        if(!chunk) {
+            return {};
+        }
+        chunks[key] = chunk;
+    }
+    if(stream.status() != QDataStream::Ok) {
+        return {};
+    }
+    return chunks;
+}
+
+void writeParseCache(QString const& fileName, CachedChunks const& chunks) {
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QByteArray data;
+    quint32 numberChunks = 0;
+    for(auto const& [key, chunk]: chunks) {
+        // chunks with errors are parsed again, so they show the error
+        if(chunk->mParserError) {
+            continue;
+        }
+        QByteArray chunkData;
+        QDataStream chunkStream(&chunkData, QIODevice::WriteOnly);
+        chunkStream.setVersion(QDataStream::Qt_5_15);
+        chunkStream << key;
+        if(writeChunk(chunkStream, *chunk)) {
+            data.append(chunkData);
+            numberChunks++;
+        }
+    }
+
+    QDataStream fileStream(&file);
+    fileStream.setVersion(QDataStream::Qt_5_15);
+    fileStream << magic << cacheVersion << QString(PROJECT_VER) << numberChunks;
+    fileStream.writeRawData(data.constData(), data.size());
+    file.commit();
+}
@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+
+#include "parser.h"
+
+#include <QByteArray>
+#include <unordered_map>
+
+// Parsed chunks of a document stored on disk, so that opening a project does not
+// parse the slides again that did not change since the document was saved.
+// The chunks are found by the hash of their text.
+using CachedChunks = std::unordered_map<QByteArray, std::shared_ptr<ParsedChunk const>>;
+
+// file in the cache location that belongs to the document
+QString parseCacheFileName(QString const& documentPath);
+QByteArray parseCacheKey(QStringView text);
+
+// a missing or outdated file gives no chunks
+CachedChunks readParseCache(QString const& fileName);
+void writeParseCache(QString const& fileName, CachedChunks const& chunks);
+
+#endif // PARSECACHE_H
@@ -21,37 +21,115 @@
 #include "potatoParser.h"
 #include "potatoformatvisitor.h"
 #include "potatoerrorlistener.h"
+#include "nativeparser.h"
+#include "twostageparse.h"
+#include "slideassembler.h"
+#include "slidesplitter.h"
 
-ParserOutput generateSlides(std::string text, QString directory, bool isTemplate) {
-    std::istringstream str(text);
-    antlr4::ANTLRInputStream input(str);
+namespace {
+
+// Runs lexer and parser on the text and walks the tree with a PotatoFormatVisitor
+std::optional<ParserError> parseWithAntlr(QStringView text, SlideListBuilder& builder) {
+    // ANTLR decodes the UTF-8 once into its own buffer
+    auto const utf8 = text.toUtf8();
+    antlr4::ANTLRInputStream input(utf8.constData(), size_t(utf8.size()));
     potatoLexer lexer(&input);
     antlr4::CommonTokenStream tokens(&lexer);
 
     tokens.fill();
     potatoParser parser(&tokens);
-    parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::SLL);
 
     parser.removeErrorListeners(); // remove ConsoleErrorListener
     PotatoErrorListener errorListener;
     parser.addErrorListener(&errorListener); // add ours
 
-    antlr4::tree::ParseTree *tree = parser.potato();
+    antlr4::tree::ParseTree *tree = parseTwoStage(parser, &potatoParser::potato);
     if(!errorListener.success()) {
         auto const error = errorListener.error();
         return ParserError{error.message, int(error.line)-1};
     }
 
-    auto listener = PotatoFormatVisitor(parser);
-    listener.setDirectory(directory);
-    listener.setParseTemplate(isTemplate);
+    auto listener = PotatoFormatVisitor(text, builder);
     try {
         auto walker = antlr4::tree::ParseTreeWalker();
         walker.walk(&listener, tree);
-        return ParserOutput(listener.slides(), listener.preamble());
+    }  catch (ParserError error) {
+        return error;
+    }
+    return {};
+}
 
+std::optional<ParserError> parseNative(QStringView text, SlideListBuilder& builder) {
+    try {
+        NativeParser(text, builder).parse();
     }  catch (ParserError error) {
-        return ParserOutput(error);
+        return error;
+    }
+    return {};
+}
+
+std::optional<ParserError> parse(QStringView text, SlideListBuilder& builder, ParserBackend backend) {
+    if(backend == ParserBackend::ANTLR) {
+        return parseWithAntlr(text, builder);
     }
+    return parseNative(text, builder);
+}
 
 }
+
+ParserOutput generateSlides(QStringView text, QString const& directory, bool isTemplate, ParserBackend backend) {
+    SlideListBuilder builder;
+    builder.setDirectory(directory);
+    builder.setParseTemplate(isTemplate);
+    if(auto const error = parse(text, builder, backend)) {
+        return ParserOutput(error.value());
+    }
+    if(!builder.includes().empty()) {
+        return ParserOutput(includeNotSupported(builder.includes().front()));
+    }
+    return ParserOutput(builder.takeSlides(), builder.preamble());
+}
+
+ParsedChunk parseChunk(QStringView text, bool isTemplate, ParserBackend backend) {
+    ParsedChunk chunk;
+    SlideListBuilder builder;
+    builder.setParseTemplate(isTemplate);
+    chunk.mParserError = parse(text, builder, backend);
+    if(!chunk.mParserError) {
+        chunk.mSlideList = builder.takeSlides();
+        chunk.mPreamble = builder.preamble();
+        chunk.mVariableAssignments = builder.variableAssignments();
+        chunk.mIncludes = builder.includes();
+    }
+    return chunk;
+}
+
+ParserError includeNotSupported(Include const& include) {
+    return ParserError{QString("Cannot include %1, \\include is only possible in a presentation.").arg(include.fileName), include.line};
+}
+
+ParserOutput generateSlidesFromFile(QString const& fileName, QString const& directory, bool isTemplate) {
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return ParserOutput(ParserError{QString("Cannot open file %1.").arg(fileName), 0});
+    }
+    auto const size = file.size();
+    auto const data = size > 0 ? file.map(0, size) : nullptr;
+    if(size > 0 && !data) {
+        return ParserOutput(ParserError{QString("Cannot read file %1.").arg(fileName), 0});
+    }
+    // "\slide" and the brackets are ASCII, so the UTF-8 bytes can be split directly
+    auto const chunks = splitAtSlides(std::string_view(reinterpret_cast<char const*>(data), std::size_t(size)));
+    SlideAssembler assembler(directory);
+    for(auto const& chunk: chunks) {
+        // an empty preamble is no error
+        if(chunk.text.empty() && chunks.size() > 1) {
+            continue;
+        }
+        auto const text = QString::fromUtf8(chunk.text.data(), int(chunk.text.size()));
+        if(auto const error = assembler.append(parseChunk(text, isTemplate), chunk.line)) {
+            return ParserOutput(error.value());
+        }
+    }
+    return assembler.output();
+}
@@ -8,23 +8,29 @@
 #define PARSER_H
 
 #include "presentation.h"
-#include "potatoformatvisitor.h"
+#include "slidelistbuilder.h"
 
 #include <QFile>
 #include <QString>
+#include <QStringList>
 
 
 struct ParserOutput {
     std::optional<ParserError> mParserError;
     std::optional<SlideList> mSlideList;
     std::optional<Preamble> mPreamble;
+    // error in a part of the input that was replaced by its last version without error,
+    // the output is still successfull and its slides of the part are marked as outdated
+    std::optional<ParserError> mRecoveredError;
+    // absolute paths of the files read for \include commands, also set with an error
+    QStringList mIncludedFiles;
 
     ParserOutput(ParserError error) {
         mParserError = error;
     }
     ParserOutput(SlideList slideList, Preamble preamble) {
-        mSlideList = slideList;
-        mPreamble = preamble;
+        mSlideList = std::move(slideList);
+        mPreamble = std::move(preamble);
     }
 
     bool successfull() const {
@@ -36,13 +42,43 @@ struct ParserOutput {
     SlideList slideList() const {
         return mSlideList.value_or(SlideList());
     }
+    // moves the slides out of the output, e.g. into the PresentationData
+    SlideList takeSlideList() {
+        return std::move(mSlideList).value_or(SlideList());
+    }
     Preamble preamble() const {
         return mPreamble.value_or(Preamble{""});
     }
 };
 
 
-ParserOutput generateSlides(std::string text, QString directory, bool isTemplate=false);
+// Output of the parser for a part of the input. Lines are counted from the
+// beginning of the part and the slides do not know about variables set before.
+struct ParsedChunk {
+    std::optional<ParserError> mParserError;
+    SlideList mSlideList;
+    Preamble mPreamble{"", 0};
+    std::vector<VariableAssignment> mVariableAssignments;
+    std::vector<Include> mIncludes;
+};
+
+
+// The native parser is used by default, the ANTLR parser generated from potato.g4
+// is the reference it is tested against.
+enum class ParserBackend {
+    Native,
+    ANTLR
+};
+
+// The text is only read during the call and not copied by the native parser
+ParserOutput generateSlides(QStringView text, QString const& directory, bool isTemplate=false, ParserBackend backend=ParserBackend::Native);
+ParsedChunk parseChunk(QStringView text, bool isTemplate=false, ParserBackend backend=ParserBackend::Native);
+// error for an \include that is not read by the IncrementalParser
+ParserError includeNotSupported(Include const& include);
+
+// Parses the file slide by slide with the native parser. The file is mapped into memory
+// and only the text of the current slide is decoded, e.g. for large generated files.
+ParserOutput generateSlidesFromFile(QString const& fileName, QString const& directory, bool isTemplate=false);
 
 
 #endif // PARSER_H
@@ -0,0 +1,175 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "parsertest.h"
+
+#include "parser.h"
+#include "incrementalparser.h"
+#include "parsecache.h"
+#include "testdump.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <map>
+
+QTEST_MAIN(ParserTest)
+
+void ParserTest::testIncrementalParse() {
+    auto slides = QStringList{"\\slide one\n\\text a\n", "\\slide two\n\\text b\n\\setvar speaker Alice\n",
+                              "\\slide three\n\\text %{speaker}\n\\section Second\n", "\\slide four\n\\text %{section}\n"};
+    IncrementalParser parser;
+    auto output = parser.parse(slides.join(""), {});
+    QVERIFY(output.successfull());
+    QCOMPARE(dump(output), dump(generateSlides(slides.join(""), {})));
+    auto const parsedBoxes = [](ParserOutput const& output) {
+        std::map<QString, Box const*> boxes;
+        for(auto const& slide: output.slideList().vector) {
+            boxes[slide->id()] = slide->parsedBoxes().front().get();
+        }
+        return boxes;
+    };
+    auto const before = parsedBoxes(output);
+
+    // the slides after the inserted one get new page numbers and lines, the variables
+    // before them change
+    slides[0] = "\\slide one\n\\text changed\n";
+    slides.insert(1, "\\slide inserted\n\\text %{speaker} %{section}\n\\setvar speaker Bob\n");
+    output = parser.parse(slides.join(""), {});
+    QVERIFY(output.successfull());
+    QCOMPARE(dump(output), dump(generateSlides(slides.join(""), {})));
+
+    // only the changed and the inserted slide are parsed again
+    auto const after = parsedBoxes(output);
+    QVERIFY(after.at("one") != before.at("one"));
+    QCOMPARE(after.at("two"), before.at("two"));
+    QCOMPARE(after.at("three"), before.at("three"));
+    QCOMPARE(after.at("four"), before.at("four"));
+}
+
+void ParserTest::testParseCache() {
+    // every box type, properties, pauses and variables
+    auto const chunks = QStringList{"\\setvar color red\n",
+                                    "\\slide[class: special] one\n\\title[font-size: 50] Title\n\\text[id: marked] **bold** %{pagenumber}\n"
+                                    "\\image[left: 10] image.png\n\\code[language: cpp] int i;\n\\pause\n\\plaintext plain\n",
+                                    "\\slide[defineclass: special] two\n\\geometry[angle: 20] line\n\\latex $x^2$\n\\section Intro\n",
+                                    "\\slide three\n\\tableofcontents\n\\sectionpreview\n"};
+    auto const text = chunks.join("");
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    auto const fileName = directory.filePath("deck.cache");
+    IncrementalParser writer;
+    writer.setCacheFile(fileName);
+    QVERIFY(writer.parse(text, {}).successfull());
+    writer.saveCache();
+    QCOMPARE(readParseCache(fileName).size(), std::size_t(chunks.size()));
+
+    // the slides of the stored chunks are the slides of a fresh parse
+    IncrementalParser reader;
+    reader.setCacheFile(fileName);
+    QCOMPARE(dump(reader.parse(text, {})), dump(generateSlides(text, {})));
+
+    // the stored chunks are used instead of parsing the text again
+    auto stored = readParseCache(fileName);
+    stored[parseCacheKey(chunks[3])] = std::make_shared<ParsedChunk const>(parseChunk(QString("\\slide replaced\n")));
+    writeParseCache(fileName, stored);
+    reader.clear();
+    reader.setCacheFile(fileName);
+    auto const output = reader.parse(text, {});
+    QVERIFY(output.slideList().findSlide("replaced"));
+    QVERIFY(!output.slideList().findSlide("three"));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    auto const data = file.readAll();
+    file.close();
+    auto const readChanged = [&fileName](QByteArray const& changed) {
+        QFile file(fileName);
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write(changed);
+        file.close();
+        return readParseCache(fileName);
+    };
+    // the magic is stored as QString with its length before it, the version of the cache follows it
+    auto const magicLength = 4 + 2 * QString("PotatoParseCache").size();
+    auto wrongMagic = data;
+    wrongMagic[5] = 'X';
+    QVERIFY(readChanged(wrongMagic).empty());
+    auto wrongVersion = data;
+    wrongVersion[magicLength + 3] = char(wrongVersion[magicLength + 3] + 1);
+    QVERIFY(readChanged(wrongVersion).empty());
+    QVERIFY(readChanged(data.left(data.size() - 10)).empty());
+    QCOMPARE(readChanged(data).size(), stored.size());
+}
+
+void ParserTest::testRecoverError() {
+    auto slides = QStringList{"\\slide one\n\\text a\n", "\\slide two\n\\text b\n",
+                              "\\slide three\n\\text c\n", "\\slide four\n\\text d\n"};
+    IncrementalParser parser;
+    auto output = parser.parse(slides.join(""), {});
+    QVERIFY(output.successfull());
+    QVERIFY(!output.mRecoveredError);
+    auto const good = dump(output);
+
+    // the broken slide keeps its last version, the other slides are unchanged
+    slides[2] = "\\slide three\n\\text c\n\\unknown c\n";
+    auto const broken = slides.join("");
+    auto const coldError = generateSlides(broken, {});
+    QVERIFY(!coldError.successfull());
+    output = parser.parse(broken, {});
+    QVERIFY(output.successfull());
+    QVERIFY(output.mRecoveredError);
+    QCOMPARE(output.mRecoveredError->line, coldError.parserError().line);
+    QCOMPARE(output.mRecoveredError->line, 6);
+    QCOMPARE(dump(output), good);
+    for(auto const& slide: output.slideList().vector) {
+        QCOMPARE(slide->outdated(), slide->id() == "three");
+    }
+
+    // with an inserted slide the positions of the last slides without error do not match
+    slides.insert(1, "\\slide inserted\n\\text e\n");
+    auto const inserted = slides.join("");
+    output = parser.parse(inserted, {});
+    QVERIFY(!output.successfull());
+    QVERIFY(!output.mRecoveredError);
+    QCOMPARE(dump(output), dump(generateSlides(inserted, {})));
+
+    slides[3] = "\\slide three\n\\text c\n";
+    output = parser.parse(slides.join(""), {});
+    QVERIFY(output.successfull());
+    QVERIFY(!output.mRecoveredError);
+    QCOMPARE(dump(output), dump(generateSlides(slides.join(""), {})));
+}
+
+void ParserTest::testInclude() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    auto const writeFile = [&directory](QString const& text) {
+        QFile file(directory.filePath("part.potato"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(text.toUtf8());
+    };
+    writeFile("\\slide two\n\\text b\n\\section included\n");
+
+    IncrementalParser parser;
+    auto const input = QString("\\slide one\n\\text a\n\\include part.potato\n\\slide three\n");
+    auto output = parser.parse(input, directory.path());
+    QVERIFY(output.successfull());
+    QCOMPARE(output.slideList().numberSlides(), 3);
+    QCOMPARE(output.slideList().findSlide("two")->pagenumber(), 2);
+    QCOMPARE(output.slideList().findSlide("three")->valueOfVariable("%{section}"), QString("included"));
+    QCOMPARE(output.mIncludedFiles.size(), 1);
+
+    // the changed file is read again
+    writeFile("\\slide second\n\\text b\n\\slide another\n");
+    output = parser.parse(input, directory.path());
+    QVERIFY(output.successfull());
+    QCOMPARE(output.slideList().numberSlides(), 4);
+    QCOMPARE(output.slideList().findSlide("three")->pagenumber(), 4);
+
+    writeFile("\\slide two\n\\unknown b\n");
+    QVERIFY(!parser.parse(input, directory.path()).successfull());
+    QVERIFY(!parser.parse("\\slide one\n\\include missing.potato\n", directory.path()).successfull());
+}
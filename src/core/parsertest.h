@@ -0,0 +1,22 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef PARSERTEST_H
+#define PARSERTEST_H
+
+#include <QtTest/QTest>
+
+class ParserTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIncrementalParse();
+    void testParseCache();
+    void testRecoverError();
+    void testInclude();
+};
+
+#endif // PARSERTEST_H
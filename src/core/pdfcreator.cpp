@@ -27,10 +27,15 @@ void PDFCreator::createPdf(QString filename, std::shared_ptr<Presentation> prese
     painter.setWindow(QRect(QPoint(0, 0), presentation->dimensions()));
     auto paint = std::make_shared<SlideRenderer>(painter);
     paint->setRenderHints(static_cast<PresentationRenderHints>(static_cast<int>(TargetIsVectorSurface) | static_cast<int>(NoPreviewRendering)));
-    for(auto &slide: presentation->data().slideListDefaultApplied().vector){
-        for( int i = 0; i <= slide->numberPauses(); i++) {
+    // the pages are painted from a snapshot of the slide list taken once, every slide
+    // is styled when it is painted and the pages are written in one pass
+    auto const slides = presentation->slideList().vector;
+    for(std::size_t slideIndex = 0; slideIndex < slides.size(); slideIndex++){
+        auto const& slide = slides[slideIndex];
+        auto const numberPauses = slide->numberPauses();
+        for( int i = 0; i <= numberPauses; i++) {
             paint->paintSlide(slide, i);
-            if(!(slide == presentation->data().slideListDefaultApplied().vector.back() && i == slide->numberPauses())){
+            if(!(slideIndex + 1 == slides.size() && i == numberPauses)){
                 pdfWriter.newPage();
             }
         }
@@ -50,9 +55,10 @@ void PDFCreator::createPdfHandout(QString filename, std::shared_ptr<Presentation
     painter.begin(&pdfWriter);
     painter.setWindow(QRect(QPoint(0, 0), presentation->dimensions()));
     auto paint = std::make_shared<SlideRenderer>(painter);
-    for(auto &slide: presentation->data().slideListDefaultApplied().vector){
-        paint->paintSlide(slide);
-        if(slide != presentation->data().slideListDefaultApplied().vector.back()){
+    auto const slides = presentation->slideList().vector;
+    for(std::size_t slideIndex = 0; slideIndex < slides.size(); slideIndex++){
+        paint->paintSlide(slides[slideIndex]);
+        if(slideIndex + 1 != slides.size()){
             pdfWriter.newPage();
         }
     }
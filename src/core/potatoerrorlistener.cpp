@@ -17,6 +17,10 @@ PotatoErrorListener::PotatoErrorListener()
 
 void PotatoErrorListener::syntaxError(antlr4::Recognizer *recognizer, antlr4::Token * offendingSymbol, size_t line, size_t charPositionInLine,
                       const std::string &msg, std::exception_ptr e) {
+    // keep the first error, the ones after it are caused by the recovery of the parser
+    if(!mSuccess) {
+        return;
+    }
     mSuccess = false;
     std::vector<std::string> rules = static_cast<antlr4::Parser*>(recognizer)->getRuleInvocationStack();
     auto message = QString("");
@@ -8,25 +8,16 @@
 #define POTATOFORMATVISITOR_H
 
 #include "potatoBaseListener.h"
-#include "slide.h"
-#include "presentation.h"
+#include "slidelistbuilder.h"
 
 #include <QString>
 
-struct ParserError{
-    QString message;
-    int line;
-};
-
-struct Preamble {
-    QString templateName;
-    int line;
-};
-
+// Walks the ANTLR parse tree and hands the commands to a SlideListBuilder.
+// The texts are views into the input the tree was parsed from.
 class PotatoFormatVisitor : public potatoBaseListener
 {
 public:
-    PotatoFormatVisitor(potatoParser& parser);
+    PotatoFormatVisitor(QStringView input, SlideListBuilder& builder);
 
     void enterCommand(potatoParser::CommandContext * /*ctx*/) override;
     void enterText(potatoParser::TextContext * ctx) override;
@@ -35,52 +26,17 @@ public:
     void exitBox(potatoParser::BoxContext * /*ctx*/) override;
     void exitPotato(potatoParser::PotatoContext * /*ctx*/) override;
 
-    void setDirectory(QString directory);
-    void applyPause(QString text);
-
-//    acess varibles
-    SlideList slides() const;
-    Preamble preamble() const;
-    void setParseTemplate(bool isTemplate);
-    void setVariables(std::map<QString, QString> variables);
-    std::map<QString, QString> Variables() const;
-
 private:
-    void newSlide(QString id, int line);
-
-    void readPreambleCommand(QString command, QString text, int line);
-
-//    create new Box
-    void createNewBox(QString command, QString text, int line);
-
-    void setVariable(QString text, int line);
-    void setSection(QString section, int line);
-    void setSubsection(QString subsection, int line);
-    QString generateId(QString type, QString boxclass);
+    // part of the input from the start of the first to the end of the last token
+    QStringView slice(antlr4::Token* first, antlr4::Token* last) const;
+    // ANTLR counts code points, QString counts UTF-16 code units
+    int utf16Index(size_t codePointIndex) const;
 
 private:
-    SlideList mSlideList;
-    std::set<QString> mBoxIds;
-
-    QString mResourcepath;
-
-    bool mParsingTemplate = false;
-    int mPauseCount = 0;
-    Preamble mPreamble;
-
-    bool mInProbertyList = false;
-    bool mLastCommandSetVariable = false;
-    bool mInPreamble = true;
-
-    QString mText;
-    QString mCommand;
-
-    // style set by the properties in the squared brackets
-    Box::Properties mProperties;
-    // varaibles set by setvalue
-    std::map<QString, QString> mVariables;
-
-    potatoParser& mParser;
+    QStringView mInput;
+    // code point indices of the characters that take two code units
+    std::vector<size_t> mSurrogatePairs;
+    SlideListBuilder& mBuilder;
 };
 
 #endif // POTATOFORMATVISITOR_H
@@ -11,24 +11,18 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QBuffer>
-#include <QDebug> 
+#include <QDebug>
+#include <algorithm>
 
 namespace {
 
-void forEachBox(auto const& slides, auto func) {
+// the ids of the boxes are read without building the slides
+void forEachParsedBox(auto const& slides, auto func) {
     for (auto const& slide: slides.vector)
-        for (auto const& box: slide->boxes())
+        for (auto const& box: slide->parsedBoxes())
             func(slide, box);
 }
 
-Box::Ptr findBoxCondition(std::vector<Slide::Ptr> slides, auto func) {
-    for (auto const& slide: slides)
-        for (auto const& box: slide->boxes())
-            if(func(slide, box))
-                return box;
-    return {};
-}
-
 }
 
 Presentation::Presentation() : QObject()
@@ -36,8 +30,25 @@ Presentation::Presentation() : QObject()
 }
 
 void Presentation::setData(PresentationData data) {
-    mData = data;
-    mData.applyConfiguration(mConfig);
+    replaceData(std::move(data), false);
+}
+
+void Presentation::setConfiguredData(PresentationData data, int configRevision) {
+    // the configuration changed while the data was build
+    replaceData(std::move(data), configRevision == mConfigRevision);
+}
+
+void Presentation::replaceData(PresentationData data, bool configured) {
+    if(!configured) {
+        data.applyConfiguration(mConfig);
+    }
+    // every slide can look different with another template or configuration
+    auto const restyled = data.presentationTemplate() != mData.presentationTemplate() || mDataConfigRevision != mConfigRevision;
+    auto const diff = diffSlideLists(mData.slides(), data.slides(), restyled);
+    mData = std::move(data);
+    mDataConfigRevision = mConfigRevision;
+    // also an empty diff is emited, the views have to use the slides of the new data
+    Q_EMIT slideListChanged(diff);
 }
 
 const SlideList &Presentation::slideList() const {
@@ -51,35 +62,74 @@ void Presentation::setBoxGeometry(const QString &boxId, BoxGeometry const& rect,
     }
     box->setGeometry(rect);
     mConfig.addRect(rect.toValue(), boxId);
-    Q_EMIT slideChanged(pageNumber, pageNumber);
+    increaseConfigRevision();
+    // the boxes of a class defined by the box move with it
+    if(box->style().mDefineclass) {
+        emitSlidesChanged(mData.restyleBox(boxId, mConfig));
+    }
+    else {
+        Q_EMIT slideChanged(pageNumber, pageNumber);
+    }
     Q_EMIT boxGeometryChanged();
 }
 
-void Presentation::deleteBoxGeometry(const QString &boxId, int pageNumber) {
+void Presentation::deleteBoxGeometry(const QString &boxId) {
     mConfig.deleteRect(boxId);
-    findBox(boxId)->setGeometry(BoxGeometry());
-    mData.applyConfiguration(mConfig);
-    Q_EMIT slideChanged(pageNumber, pageNumber);
+    increaseConfigRevision();
+    emitSlidesChanged(mData.restyleBox(boxId, mConfig));
     Q_EMIT boxGeometryChanged();
 }
 
-void Presentation::deleteBoxAngle(const QString &boxId, int pageNumber) {
+void Presentation::deleteBoxAngle(const QString &boxId) {
     mConfig.deleteAngle(boxId);
-    auto const box = findBox(boxId);
-    auto const rect = box->geometry().rect();
-    findBox(boxId)->setGeometry(BoxGeometry(rect, 0));
-    mData.applyConfiguration(mConfig);
-    Q_EMIT slideChanged(pageNumber, pageNumber);
+    increaseConfigRevision();
+    emitSlidesChanged(mData.restyleBox(boxId, mConfig));
     Q_EMIT boxGeometryChanged();
 }
 
+void Presentation::increaseConfigRevision() {
+    // the data keeps up with the configuration if it had the last one applied
+    auto const upToDate = mDataConfigRevision == mConfigRevision;
+    mConfigRevision++;
+    if(upToDate) {
+        mDataConfigRevision = mConfigRevision;
+    }
+}
+
+void Presentation::emitSlidesChanged(std::vector<int> const& positions) {
+    if(!positions.empty()) {
+        Q_EMIT slideChanged(positions.front(), positions.back());
+    }
+}
+
 const ConfigBoxes &Presentation::configuration() const {
     return mConfig;
 }
 
+int Presentation::configRevision() const {
+    return mConfigRevision;
+}
+
 void Presentation::setConfig(ConfigBoxes config) {
+    auto const changedIds = mConfig.changedIds(config);
+    if(changedIds.empty()) {
+        return;
+    }
     mConfig = config;
-    Q_EMIT rebuildNeeded();
+    increaseConfigRevision();
+    if(mDataConfigRevision != mConfigRevision) {
+        Q_EMIT rebuildNeeded();
+        return;
+    }
+    // the data that has the configuration applied only needs the changed boxes styled again
+    std::vector<int> positions;
+    for(auto const& id: changedIds) {
+        auto const changed = mData.restyleBox(id, mConfig);
+        positions.insert(positions.end(), changed.begin(), changed.end());
+    }
+    std::sort(positions.begin(), positions.end());
+    emitSlidesChanged(positions);
+    Q_EMIT boxGeometryChanged();
 }
 
 
@@ -94,23 +144,8 @@ int Presentation::numberOfSlides() const {
 }
 
 Box::Ptr Presentation::findBox(const QString &id) const {
-    if(id.startsWith("intern")) {
-        auto const box = findBoxCondition(mData.slides().vector, [id](auto const& slide, auto const& box) {
-            return id.contains(slide->id()) && box->id() == id;
-        });
-        if (box)
-            return box;
-    }
-
-    else{
-        auto const box = findBoxCondition(mData.slides().vector, [id](auto const& slide, auto const& box) {
-            return box->id() == id;
-        });
-        if (box)
-            return box;
-    }
-
-    return {};
+    // the index of the slide list builds only the slide of the box
+    return mData.slides().findBox(id);
 }
 
 std::pair<Slide::Ptr, Box::Ptr> Presentation::findBoxForLine(int line) const {
@@ -141,11 +176,13 @@ std::pair<Slide::Ptr, Box::Ptr> Presentation::findBoxForLine(int line) const {
 
 void Presentation::deleteNotNeededConfigurations() {
     std::vector<QString> ids;
-    forEachBox(mData.slides(), [&ids](Slide::Ptr slide, Box::Ptr box){
+    forEachParsedBox(mData.slides(), [&ids](Slide::Ptr slide, Box::Ptr box){
         ids.push_back(box->id());
     });
     mConfig.deleteAllRectsExcept(ids);
-    Q_EMIT slideChanged(0, mData.slides().numberSlides());
+    // only entries of boxes that do not exist are deleted, the slides are unchanged
+    increaseConfigRevision();
+    Q_EMIT boxGeometryChanged();
 }
 
 
@@ -153,12 +190,7 @@ QString Presentation::title() const {
     if(mData.slides().empty()) {
         return "presentation";
     }
-    auto const& variables = mData.slides().lastSlide()->variables();
-    auto const& title = variables.find("%{title}");
-    if(title == variables.end()) {
-        return "presentation";
-    }
-    return title->second;
+    return mData.slides().lastSlide()->variables().value("%{title}").value_or("presentation");
 }
 
 PresentationData &Presentation::data() {
@@ -13,6 +13,7 @@
 #include "slide.h"
 #include "configboxes.h"
 #include "presentationdata.h"
+#include "slidelistdiff.h"
 
 class Template;
 
@@ -28,6 +29,8 @@ public:
 
     // set data
     void setData(PresentationData data);
+    // set data that is already configured with the configuration of the given revision
+    void setConfiguredData(PresentationData data, int configRevision);
 
     // Access contained Slides
     SlideList const& slideList() const;
@@ -47,12 +50,15 @@ public:
     // Change Geometry of Box only through the presentation in order to
     // save it in the Configuration
     void setBoxGeometry(QString const& boxId, const BoxGeometry &rect, int pageNumber);
-    void deleteBoxGeometry(QString const& boxId, int pageNumber);
-    void deleteBoxAngle(QString const& boxId, int pageNumber);
+    // only the box and the boxes of a class defined by it are styled again
+    void deleteBoxGeometry(QString const& boxId);
+    void deleteBoxAngle(QString const& boxId);
 
     // Configuration Class to follow and save the Geometry of the boxes
     void setConfig(ConfigBoxes config);
     ConfigBoxes const& configuration() const;
+    // counts the changes of the configuration
+    int configRevision() const;
 
     // deletes the configuration entries from boxes that do not exist
     // in the presentation at the moment
@@ -61,12 +67,25 @@ public:
 Q_SIGNALS:
     // emited if the position of a box on a slide is changed
     void slideChanged(int pageNumberFront, int pageNumberBack);
+    // emited if new data was set, with the changes to the slides of the old data
+    void slideListChanged(SlideListDiff const& diff);
     void rebuildNeeded();
     void boxGeometryChanged();
 
+private:
+    // replaces the data and emits the changes
+    void replaceData(PresentationData data, bool configured);
+    // counts a change of the configuration that is applied to the data by the caller
+    void increaseConfigRevision();
+    // emits slideChanged for the range of the sorted positions
+    void emitSlidesChanged(std::vector<int> const& positions);
+
 private:
     PresentationData mData;
     ConfigBoxes mConfig;
+    int mConfigRevision = 0;
+    // revision of the configuration that is applied to the data
+    int mDataConfigRevision = 0;
 
     QSize mDimensions{1600, 900};
 };
@@ -0,0 +1,123 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "presentationbuilder.h"
+
+#include <QDir>
+
+PresentationBuilder::PresentationBuilder(QObject *parent)
+    : QObject(parent)
+{
+    // the builds share the parser and the template, so they must not run in parallel
+    mThreadPool.setMaxThreadCount(1);
+}
+
+PresentationBuilder::~PresentationBuilder() {
+    mGeneration++;
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+}
+
+void PresentationBuilder::build(QString const& text, QString const& directory, ConfigBoxes const& config, int configRevision,
+                                Template::Ptr cachedTemplate, QString const& templatePath) {
+    auto const generation = ++mGeneration;
+    // the copy of the configuration is shared by the build and the slides styled later
+    auto const configuration = std::make_shared<ConfigBoxes const>(config);
+    // outdated requests return right away, they are not removed from the pool
+    // as the queue also contains the tasks for the parser
+    mThreadPool.start([=, this](){
+        if(outdated(generation)) {
+            return;
+        }
+        auto result = run(generation, text, directory, configuration, cachedTemplate, templatePath);
+        if(outdated(generation)) {
+            return;
+        }
+        result.mConfigRevision = configRevision;
+        QMetaObject::invokeMethod(this, [this, result = std::move(result)](){
+            if(!outdated(result.mGeneration)) {
+                Q_EMIT finished(result);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PresentationBuilder::clear() {
+    mGeneration++;
+    mThreadPool.start([this](){
+        mParser.clear();
+    });
+}
+
+void PresentationBuilder::setCacheFile(QString const& fileName) {
+    mThreadPool.start([this, fileName](){
+        mParser.setCacheFile(fileName);
+    });
+}
+
+void PresentationBuilder::saveCache() {
+    mThreadPool.start([this](){
+        mParser.saveCache();
+    });
+}
+
+bool PresentationBuilder::outdated(int generation) const {
+    return generation != mGeneration;
+}
+
+BuildResult PresentationBuilder::run(int generation, QString const& text, QString const& directory, std::shared_ptr<ConfigBoxes const> config,
+                                     Template::Ptr cachedTemplate, QString const& templatePath) {
+    BuildResult result{generation, {}, {}, nullptr, "", 0};
+    // the parse is not cancelled, the parsed chunks are reused by the next build
+    auto parserOutput = mParser.parse(text, directory);
+    result.mIncludedFiles = parserOutput.mIncludedFiles;
+    if(!parserOutput.successfull()) {
+        auto const error = parserOutput.parserError();
+        result.mError = BuildError{error.message, error.line};
+        return result;
+    }
+    // the slides with the error are replaced by their last version, the others are still shown
+    if(auto const& error = parserOutput.mRecoveredError) {
+        result.mError = BuildError{error->message, error->line};
+    }
+    if(outdated(generation)) {
+        return result;
+    }
+
+    auto const preamble = parserOutput.preamble();
+    auto templateName = preamble.templateName;
+    Template::Ptr presentationTemplate = nullptr;
+    if(!templateName.isEmpty()) {
+        if (!QDir::isAbsolutePath(templateName)) {
+            templateName = directory + "/" + templateName;
+        }
+        if(templateName == templatePath && cachedTemplate) {
+            presentationTemplate = cachedTemplate;
+        }
+        else {
+            try {
+                presentationTemplate = loadTemplate(templateName);
+            }  catch (TemplateError) {
+                result.mError = BuildError{"Cannot load template", preamble.line};
+                return result;
+            }
+            result.mLoadedTemplate = presentationTemplate;
+            result.mTemplatePath = templateName;
+        }
+    }
+    if(outdated(generation)) {
+        return result;
+    }
+
+    try {
+        PresentationData data(parserOutput.takeSlideList(), presentationTemplate);
+        data.applyConfiguration(std::move(config));
+        result.mData = std::move(data);
+    }  catch (PorpertyConversionError error) {
+        result.mError = BuildError{error.message, error.line};
+    }
+    return result;
+}
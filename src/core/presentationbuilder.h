@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef PRESENTATIONBUILDER_H
+#define PRESENTATIONBUILDER_H
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <optional>
+
+#include "incrementalparser.h"
+#include "presentationdata.h"
+#include "template.h"
+
+struct BuildError {
+    QString message;
+    int line;
+};
+
+struct BuildResult {
+    int mGeneration;
+    std::optional<PresentationData> mData;
+    // with data the error belongs to a slide that shows its last version without error
+    std::optional<BuildError> mError;
+    // template loaded during the build, nullptr if the given template was used
+    Template::Ptr mLoadedTemplate;
+    QString mTemplatePath;
+    int mConfigRevision;
+    // files included by the input, also set with an error
+    QStringList mIncludedFiles;
+};
+
+// Parses the input and applies the configuration in a background thread.
+// Only one build runs at a time, builds that are outdated by a newer request
+// are dropped and finished is only emitted for the latest request.
+class PresentationBuilder : public QObject
+{
+    Q_OBJECT
+public:
+    PresentationBuilder(QObject *parent = nullptr);
+    ~PresentationBuilder();
+
+    // cachedTemplate is used if the preamble refers to templatePath
+    void build(QString const& text, QString const& directory, ConfigBoxes const& config, int configRevision,
+               Template::Ptr cachedTemplate, QString const& templatePath);
+    // drop running builds and forget the parsed chunks
+    void clear();
+    // the parse cache of the document, see IncrementalParser
+    void setCacheFile(QString const& fileName);
+    void saveCache();
+
+Q_SIGNALS:
+    void finished(BuildResult const& result);
+
+private:
+    bool outdated(int generation) const;
+    BuildResult run(int generation, QString const& text, QString const& directory, std::shared_ptr<ConfigBoxes const> config,
+                    Template::Ptr cachedTemplate, QString const& templatePath);
+
+private:
+    QThreadPool mThreadPool;
+    std::atomic<int> mGeneration = 0;
+    // only used from the thread of the pool
+    IncrementalParser mParser;
+};
+
+#endif // PRESENTATIONBUILDER_H
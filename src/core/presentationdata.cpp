@@ -1,165 +1,9 @@
 #include "presentationdata.h"
-#include "utils.h"
 #include "template.h"
 
-namespace  {
-
-void forEachBox(auto const& slides, auto func) {
-    for (auto const& slide: slides.vector)
-        for (auto const& box: slide->boxes())
-            func(slide, box);
-}
-
-void applyClassIDDefinclass(SlideList & slides) {
-    forEachBox(slides, [](Slide::Ptr slide, Box::Ptr box) {
-        if(box->properties().find("class") != box->properties().end()) {
-            box->style().mClass = box->properties().find("class")->second.mValue;
-        }
-        if(box->properties().find("id") != box->properties().end()) {
-            box->style().mId = box->properties().find("id")->second.mValue;
-        }
-        if(box->properties().find("defineclass") != box->properties().end()) {
-            box->style().mDefineclass = box->properties().find("defineclass")->second.mValue;
-        }
-    });
-}
-
-void applyGeometryToBoxIfSetInModel(Box::Ptr box, const BoxGeometry &modelGeometry) {
-
-    if(modelGeometry.left()) {
-        box->geometry().setLeft(modelGeometry.leftDisplay());
-    }
-    if(modelGeometry.top()) {
-        box->geometry().setTop(modelGeometry.topDisplay());
-    }
-    if(modelGeometry.width()) {
-        box->geometry().setWidth(modelGeometry.widthDisplay());
-    }
-    if(modelGeometry.height()) {
-        box->geometry().setHeight(modelGeometry.heightDisplay());
-    }
-    if(modelGeometry.angle()) {
-        box->geometry().setAngle(modelGeometry.angleDisplay());
-    }
-}
+#include <algorithm>
 
-void applyStandardTemplateToBox(Box::Ptr box) {
-    QRect rect;
-    auto style = box->style();
-
-    // set standard geometry
-    if(style.getClass() == "title") {
-        rect = QRect(50, 40, 1500, 100);
-    }
-    else if(style.getClass() == "body") {
-        rect = QRect(50, 150, 1500, 650);
-    }
-    else if(style.getClass() == "code") {
-        rect = QRect(50, 150, 1500, 650);
-        if(!style.mFont) {
-            style.mFont = "DejaVu Sans Mono";
-        }
-    }
-    else if(style.getClass() == "image") {
-        rect = QRect(50, 150, 1500, 650);
-    }
-    else if(style.getClass() == "right_column") {
-        rect = QRect(830, 150, 720, 650);
-    }
-    else if(style.getClass() == "left_column") {
-        rect = QRect(50, 150, 720, 650);
-    }
-    else if(style.getClass() == "fullscreen") {
-        rect = QRect(0, 0, 1600, 900);
-    }
-    else {
-        rect = QRect(50, 200, 300, 100);
-    }
-
-    applyGeometryToBoxIfSetInModel(box, BoxGeometry(rect, 0));
-}
-
-void applyStandardTemplate(SlideList &slides) {
-    forEachBox(slides, [](Slide::Ptr slide, Box::Ptr box){
-        applyStandardTemplateToBox(box);
-    });
-}
-
-void forEachTemplateBox(auto const& slides, auto func) {
-    for (auto const& slide: slides.vector)
-        for (auto const& box: slide->templateBoxes())
-            func(slide, box);
-}
-
-void setStyleToBoxIfSetInModel(Box::Ptr box, BoxStyle const& modelStyle) {
-    auto const assignIfSet = [](auto& value, auto const& standard) {
-        if(standard) {
-            value = standard;
-        }
-    };
-
-    assignIfSet(box->style().mFont, modelStyle.mFont);
-    assignIfSet(box->style().mFontSize, modelStyle.mFontSize);
-    assignIfSet(box->style().mFontWeight, modelStyle.mFontWeight);
-    assignIfSet(box->style().mColor, modelStyle.mColor);
-    assignIfSet(box->style().mBackgroundColor, modelStyle.mBackgroundColor);
-    assignIfSet(box->style().mAlignment, modelStyle.mAlignment);
-    assignIfSet(box->style().mLanguage, modelStyle.mLanguage);
-    assignIfSet(box->style().mHighlight, modelStyle.mHighlight);
-    assignIfSet(box->style().mLineSpacing, modelStyle.mLineSpacing);
-    assignIfSet(box->style().mOpacity, modelStyle.mOpacity);
-    assignIfSet(box->style().mPadding, modelStyle.mPadding);
-    assignIfSet(box->style().mBorderRadius, modelStyle.mBorderRadius);
-    assignIfSet(box->style().mTextMarker.color, modelStyle.mTextMarker.color);
-    assignIfSet(box->style().mTextMarker.fontWeight, modelStyle.mTextMarker.fontWeight);
-    assignIfSet(box->style().mBorder.width, modelStyle.mBorder.width);
-    assignIfSet(box->style().mBorder.style, modelStyle.mBorder.style);
-    assignIfSet(box->style().mBorder.color, modelStyle.mBorder.color);
-    if(modelStyle.mText && !modelStyle.mText->isEmpty()) {
-        box->style().mText = modelStyle.mText;
-    }
-}
-
-void setStyleToBoxIfNotSettedAndSetInModel(Box::Ptr box, BoxStyle const& modelStyle) {
-    auto const assignIfSet = [](auto& value, auto const& standard) {
-        if(standard && !value) {
-            value = standard;
-        }
-    };
-
-    assignIfSet(box->style().mFont, modelStyle.mFont);
-    assignIfSet(box->style().mFontSize, modelStyle.mFontSize);
-    assignIfSet(box->style().mFontWeight, modelStyle.mFontWeight);
-    assignIfSet(box->style().mColor, modelStyle.mColor);
-    assignIfSet(box->style().mBackgroundColor, modelStyle.mBackgroundColor);
-    assignIfSet(box->style().mAlignment, modelStyle.mAlignment);
-    assignIfSet(box->style().mLanguage, modelStyle.mLanguage);
-    assignIfSet(box->style().mHighlight, modelStyle.mHighlight);
-    assignIfSet(box->style().mLineSpacing, modelStyle.mLineSpacing);
-    assignIfSet(box->style().mOpacity, modelStyle.mOpacity);
-    assignIfSet(box->style().mPadding, modelStyle.mPadding);
-    assignIfSet(box->style().mBorderRadius, modelStyle.mBorderRadius);
-    assignIfSet(box->style().mTextMarker.color, modelStyle.mTextMarker.color);
-    assignIfSet(box->style().mTextMarker.fontWeight, modelStyle.mTextMarker.fontWeight);
-    assignIfSet(box->style().mBorder.width, modelStyle.mBorder.width);
-    assignIfSet(box->style().mBorder.style, modelStyle.mBorder.style);
-    assignIfSet(box->style().mBorder.color, modelStyle.mBorder.color);
-    if(modelStyle.mText && !modelStyle.mText->isEmpty()) {
-        box->style().mText = modelStyle.mText;
-    }
-}
-
-void applyStandardVariables(SlideList & slides) {
-    forEachBox(slides, [](auto const& slide, auto const& box){
-        auto const boxStyle = variablesToBoxStyle(slide->variables());
-        setStyleToBoxIfNotSettedAndSetInModel(box, boxStyle);
-    });
-
-    forEachTemplateBox(slides, [](auto const& slide, auto const& box){
-        auto const boxStyle = variablesToBoxStyle(slide->variables());
-        setStyleToBoxIfNotSettedAndSetInModel(box, boxStyle);
-    });
-}
+namespace  {
 
 TableOfContent createTableOfContent(SlideList const& slides) {
     TableOfContent newTableOfContent;
@@ -217,124 +61,187 @@ TableOfContent createTableOfContent(SlideList const& slides) {
     return newTableOfContent;
 }
 
-void addTableOfContentsToContext(SlideList& slides, TableOfContent tableofcontents) {
-    for(auto const& slide: slides.vector) {
-        slide->setTableOfContents(tableofcontents);
+// key of the class defined by the box in the defined classes
+QString classKey(Slide const& slide, Box const& box) {
+    QString key = "";
+    if(!slide.definesClass().isEmpty()) {
+        key = slide.definesClass() + "-" ;
     }
+    key.append(box.style().mDefineclass.value());
+    return key;
 }
 
-void applyCSSProperties(const SlideList &slides) {
-    auto lambda = [](auto slide, auto box){
-        setStyleToBoxIfSetInModel(box, propertyMapToBoxStyle(box->properties()));
-    };
-    forEachBox(slides, lambda);
+// the box gets the style of the defined class with the key, see applyDefinedClasses
+bool usesClass(Slide const& slide, Box const& box, QString const& key) {
+    if(!box.style().mClass) {
+        return false;
+    }
+    auto const& boxClass = box.style().mClass.value();
+    return boxClass == key || slide.slideClass() + "-" + boxClass == key;
+}
+
+bool definesClass(Slide const& slide) {
+    return std::any_of(slide.parsedBoxes().begin(), slide.parsedBoxes().end(), [](auto const& box){
+        return box->properties().find(PropertyId::Defineclass) != box->properties().end();
+    });
 }
 
 }
 
 
 PresentationData::PresentationData(SlideList slides, std::shared_ptr<Template> presentationTemplate)
-    : mSlides(slides)
-    , mTemplate(presentationTemplate)
+    : mSlides(std::move(slides))
+    , mTemplate(std::move(presentationTemplate))
 {
 }
 
 void PresentationData::applyConfiguration(const ConfigBoxes &config) {
-    applyClassIDDefinclass(mSlides);
-    applyStandardTemplate(mSlides);
-    if(mTemplate) {
-        mTemplate->applyTemplate(mSlides);
-    }
-    applyDefinedClass(mSlides, config);
-
-    setTitleIfTextUnset(mSlides);
-    applyJSONGeometries(config);
-    applyCSSProperties(mSlides);
-}
-
-const SlideList &PresentationData::slides() const {
-    return mSlides;
+    applyConfiguration(std::make_shared<ConfigBoxes const>(config));
 }
 
-void PresentationData::applyDefinedClass(const SlideList &slides, const ConfigBoxes &config) {
-    auto const definedClasses = createMapDefinesClass(config);
-    forEachBox(slides, [&definedClasses](Slide::Ptr slide, Box::Ptr box){
-        auto const slideKey = slide->slideClass();
-        if(!box->style().mClass){
-            return;
+void PresentationData::applyConfiguration(std::shared_ptr<ConfigBoxes const> configuration) {
+    // the slides that define a class are styled at once up to the defined classes, the other slides need the classes
+    StyleCascade const classCascade(mTemplate, {}, configuration);
+    std::vector<bool> prepared;
+    prepared.reserve(mSlides.vector.size());
+    for(auto const& slide: mSlides.vector) {
+        if(mTemplate) {
+            mTemplate->applyVariables(*slide);
         }
-        auto const boxKey = box->style().mClass.value();
-        if(definedClasses.find(boxKey) != definedClasses.end()) {
-            auto const definedClassStyle = definedClasses.find(boxKey)->second;
-            applyGeometryToBoxIfSetInModel(box, definedClassStyle.mGeometry);
-            setStyleToBoxIfSetInModel(box, definedClassStyle);
+        prepared.push_back(definesClass(*slide));
+        if(prepared.back()) {
+            slide->setStyle({});
+            classCascade.apply(*slide, StyleCascade::Layer::StandardClasses, StyleCascade::Layer::Template);
         }
-        if(definedClasses.find(slideKey + "-" + boxKey) != definedClasses.end()) {
-            auto const definedClassStyle = definedClasses.find(slideKey + "-" + boxKey)->second;
-            applyGeometryToBoxIfSetInModel(box, definedClassStyle.mGeometry);
-            setStyleToBoxIfSetInModel(box, definedClassStyle);
+    }
+
+    auto definedClasses = std::make_shared<DefinedClasses>();
+    for(std::size_t i = 0; i < mSlides.vector.size(); i++) {
+        if(!prepared[i]) {
+            continue;
         }
-        else {
-            return;
+        auto const& slide = mSlides.vector[i];
+        for(auto const& box: slide->boxes()) {
+            if(!box->style().mDefineclass) {
+                continue;
+            }
+            classCascade.applyToBox(*slide, *box, StyleCascade::Layer::Configuration, StyleCascade::Layer::Properties);
+            (*definedClasses)[classKey(*slide, *box)] = box->style();
         }
-    });
-
-    auto const tableOfContents = createTableOfContent(slides);
-    for(auto const& slide: slides.vector) {
-        slide->setTableOfContents(tableOfContents);
     }
-}
+    mDefinedClasses = definedClasses;
+    mConfiguration = std::move(configuration);
+    mClassUsers.reset();
 
-void PresentationData::setTitleIfTextUnset(const SlideList &slides) {
-    forEachBox(slides, [](Slide::Ptr slide, Box::Ptr box){
-        if(box->style().mClass == "title" && box->style().text().isEmpty()) {
-            auto style = box->style();
-            style.mText = slide->id();
-            box->setBoxStyle(style);
+    auto const tableOfContents = createTableOfContent(mSlides);
+    auto const cascade = std::make_shared<std::shared_ptr<StyleCascade const>>(
+                std::make_shared<StyleCascade const>(mTemplate, mDefinedClasses, mConfiguration));
+    mCascade = cascade;
+    for(std::size_t i = 0; i < mSlides.vector.size(); i++) {
+        auto const& slide = mSlides.vector[i];
+        slide->setTableOfContents(tableOfContents);
+        auto const first = prepared[i] ? StyleCascade::Layer::DefinedClasses : StyleCascade::Layer::StandardClasses;
+        slide->setStyle([cascade, first](Slide& slide){
+            (*cascade)->apply(slide, first);
+        });
+    }
+}
+
+std::vector<int> PresentationData::restyleBox(QString const& boxId, ConfigBoxes const& config) {
+    auto const position = mSlides.findSlideOfBox(boxId);
+    if(position < 0) {
+        return {};
+    }
+    auto const& slide = mSlides.vector[position];
+    auto const box = slide->findBox(boxId);
+    // the slides that are built later use the new configuration, it only differs in the entry of the box
+    mConfiguration = std::make_shared<ConfigBoxes const>(config);
+    if(!box->style().mDefineclass) {
+        StyleCascade(mTemplate, mDefinedClasses, mConfiguration).applyToBox(*slide, *box, StyleCascade::Layer::StandardClasses,
+                                                                            StyleCascade::Layer::Variables);
+        if(mCascade) {
+            *mCascade = std::make_shared<StyleCascade const>(mTemplate, mDefinedClasses, mConfiguration);
         }
-    });
+        return {position};
+    }
+
+    // the style of the class is the style of the box before the defined classes are applied
+    StyleCascade const classCascade(mTemplate, {}, mConfiguration);
+    classCascade.applyToBox(*slide, *box, StyleCascade::Layer::StandardClasses, StyleCascade::Layer::Template);
+    classCascade.applyToBox(*slide, *box, StyleCascade::Layer::Configuration, StyleCascade::Layer::Properties);
+    auto const key = classKey(*slide, *box);
+    auto definedClasses = std::make_shared<DefinedClasses>(*mDefinedClasses);
+    (*definedClasses)[key] = box->style();
+    mDefinedClasses = definedClasses;
+    auto const cascade = std::make_shared<StyleCascade const>(mTemplate, mDefinedClasses, mConfiguration);
+    cascade->applyToBox(*slide, *box, StyleCascade::Layer::DefinedClasses, StyleCascade::Layer::Variables);
+    // the slides that are not built get the new class with the cascade
+    if(mCascade) {
+        *mCascade = cascade;
+    }
+
+    std::vector<int> changed{position};
+    for(auto const i: classUsers(key)) {
+        auto const& other = mSlides.vector[i];
+        if(!other->built()) {
+            continue;
+        }
+        auto slideChanged = false;
+        for(auto const& otherBox: other->boxes()) {
+            if(otherBox != box && usesClass(*other, *otherBox, key)) {
+                otherBox->setGeometry(BoxGeometry());
+                cascade->applyToBox(*other, *otherBox, StyleCascade::Layer::StandardClasses, StyleCascade::Layer::Variables);
+                slideChanged = true;
+            }
+        }
+        if(slideChanged && i != position) {
+            changed.push_back(i);
+        }
+    }
+    std::sort(changed.begin(), changed.end());
+    return changed;
 }
 
-std::map<QString, BoxStyle> PresentationData::createMapDefinesClass(ConfigBoxes const& config) const {
-    std::map<QString, BoxStyle> definitionClass;
-    forEachBox(mSlides, [&definitionClass, config, this](Slide::Ptr slide, Box::Ptr box){
-        if(box->style().mDefineclass) {
-            applyJSONToBox(slide, box, config);
-            setStyleToBoxIfSetInModel(box, propertyMapToBoxStyle(box->properties()));
-            QString key = "";
-            if(!slide->definesClass().isEmpty()) {
-                key = slide->definesClass() + "-" ;
+std::vector<int> const& PresentationData::classUsers(QString const& key) {
+    // the classes are read from the parsed boxes, so no slide is built for the index
+    if(!mClassUsers) {
+        mClassUsers.emplace();
+        auto const addUser = [this](QString const& key, int position) {
+            auto& users = (*mClassUsers)[key];
+            if(users.empty() || users.back() != position) {
+                users.push_back(position);
+            }
+        };
+        for(int i = 0; i < int(mSlides.vector.size()); i++) {
+            auto const& slide = mSlides.vector[i];
+            for(auto const& box: slide->parsedBoxes()) {
+                auto const boxClass = box->properties().find(PropertyId::Class);
+                if(boxClass == box->properties().end()) {
+                    continue;
+                }
+                // the keys that usesClass accepts
+                addUser(boxClass->second.mValue, i);
+                addUser(slide->slideClass() + "-" + boxClass->second.mValue, i);
             }
-            key.append(box->style().mDefineclass.value());
-            definitionClass[key] = box->style();
         }
-    });
-    return definitionClass;
+    }
+    static std::vector<int> const noUsers;
+    auto const users = mClassUsers->find(key);
+    return users == mClassUsers->end() ? noUsers : users->second;
 }
 
-void PresentationData::applyJSONGeometries(ConfigBoxes const& config) {
-    forEachBox(mSlides, [this, config](Slide::Ptr slide, Box::Ptr box){
-        applyJSONToBox(slide, box, config);
-    });
+const SlideList &PresentationData::slides() const {
+    return mSlides;
 }
 
-void PresentationData::applyJSONToBox(Slide::Ptr slide, Box::Ptr box, ConfigBoxes const& config) const {
-    auto const boxConfig = config.getRect(box->configId());
-    if(boxConfig.empty()) {
-        return;
-    }
-    box->geometry().setLeft(boxConfig.rect.left());
-    box->geometry().setTop(boxConfig.rect.top());
-    box->geometry().setWidth(boxConfig.rect.width());
-    box->geometry().setHeight(boxConfig.rect.height());
-    box->geometry().setAngle(boxConfig.angle);
+std::shared_ptr<PresentationData::DefinedClasses const> const& PresentationData::definedClasses() const {
+    return mDefinedClasses;
 }
 
 int PresentationData::numberSlides() const {
     return slides().numberSlides();
 }
 
-const SlideList &PresentationData::slideListDefaultApplied() {
-    applyStandardVariables(mSlides);
-    return mSlides;
+std::shared_ptr<Template> const& PresentationData::presentationTemplate() const {
+    return mTemplate;
 }
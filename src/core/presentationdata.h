@@ -3,14 +3,32 @@
 
 #include "slide.h"
 #include "configboxes.h"
+#include "stylecascade.h"
+
+#include <QHash>
+#include <map>
+#include <optional>
 
 class Template;
 
 struct SlideList {
     std::vector<Slide::Ptr> vector;
 
+    // the slide and its boxes are added to the indexes of the ids
     void appendSlide(Slide::Ptr slide) {
+        if(!mSlideIndex.contains(slide->id())) {
+            mSlideIndex.insert(slide->id(), int(vector.size()));
+        }
         vector.push_back(slide);
+        for(auto const& box: slide->parsedBoxes()) {
+            indexBox(box);
+        }
+    }
+
+    // appends the box to the last slide
+    void appendBox(Box::Ptr box) {
+        vector.back()->appendBox(box);
+        indexBox(box);
     }
 
     Slide::Ptr slideAt(int pageNumber) const {
@@ -20,22 +38,38 @@ struct SlideList {
         return vector[pageNumber];
     };
 
+    // only the slide of the box is built
     Box::Ptr findBox(QString const& id) const {
-        for(auto const& slide: vector) {
-            if(slide->findBox(id)) {
-                return slide->findBox(id);
+        auto const position = findSlideOfBox(id);
+        if(position < 0) {
+            return {};
+        }
+        return vector[position]->findBox(id);
+    };
+
+    // position of the slide that contains the box, -1 if there is none
+    int findSlideOfBox(QString const& id) const {
+        if(auto const index = mBoxIndex.find(id); index != mBoxIndex.end()) {
+            if(vector[index.value()]->containsBox(id)) {
+                return index.value();
             }
         }
-        return {};
+        // the id of a box can change after it was added, e.g. by a pause,
+        // slides that are not built yet have the ids of the index
+        for(int i = 0; i < int(vector.size()); i++) {
+            if(vector[i]->built() && vector[i]->containsBox(id)) {
+                return i;
+            }
+        }
+        return -1;
     };
 
     Slide::Ptr findSlide(QString const& id) const {
-        for(auto const &slide: vector) {
-            if(id == slide->id()) {
-                return slide;
-            }
+        auto const index = mSlideIndex.find(id);
+        if(index == mSlideIndex.end()) {
+            return {};
         }
-        return {};
+        return vector[index.value()];
     };
 
     Slide::Ptr findDefiningSlide(QString const& definition) const {
@@ -61,44 +95,69 @@ struct SlideList {
     bool empty() const {
         return vector.empty();
     }
+
+private:
+    // like the search through the slides the index finds the first box with an id,
+    // the box is in the last slide
+    void indexBox(Box::Ptr const& box) {
+        if(!mBoxIndex.contains(box->id())) {
+            mBoxIndex.insert(box->id(), int(vector.size()) - 1);
+        }
+    }
+
+    QHash<QString, int> mSlideIndex;
+    // position of the slide that contains the box
+    QHash<QString, int> mBoxIndex;
 };
 
 
 class PresentationData
 {
 public:
+    using DefinedClasses = StyleCascade::DefinedClasses;
+
     PresentationData() = default;
     PresentationData(SlideList slides, std::shared_ptr<Template> presentationTemplate=nullptr);
 
     // starts the process that applys defined classes, templates,
-    // the geometries given by config, and the properties to the boxes
+    // the geometries given by config, and the properties to the boxes,
+    // see StyleCascade for the order.
+    // Only the slides that define classes are styled at once, the others
+    // when their boxes are used, e.g. to paint or export them.
     void applyConfiguration(ConfigBoxes const& config);
-
+    // the configuration is shared with the slides that are styled later
+    void applyConfiguration(std::shared_ptr<ConfigBoxes const> config);
+    // styles the box again after its entry in the configuration changed, the other boxes
+    // keep their style. If the box defines a class, the built boxes of the class are
+    // styled again as well. Returns the sorted positions of the changed slides.
+    std::vector<int> restyleBox(QString const& boxId, ConfigBoxes const& config);
+
+    // the slides are styled, including the default properties set e.g. by \setvar color black,
+    // on the first access to their boxes and keep the styles until the configuration is applied again
+    // or a box is restyled, so painting a slide again does not style it again
     SlideList const& slides() const;
     int numberSlides() const;
+    std::shared_ptr<Template> const& presentationTemplate() const;
 
-    // use this to render slide
-    // slides with the default properties set
-    // e.g. by \setvar color black
-    SlideList const& slideListDefaultApplied();
-
-    // find the classes that are defined in the PresentationData and apply it to another SlideList
-    // (config that belongs to PresentationData is needed)
-    void applyDefinedClass(SlideList const& slides, ConfigBoxes const& config);
+    // the classes that are defined in the PresentationData, e.g. to style the slides of another presentation
+    // (the configuration has to be applied before)
+    std::shared_ptr<DefinedClasses const> const& definedClasses() const;
 
 private:
-    // creating and applying of a map of the boxes that defines
-    // a class e.g. has the argument defineclass
-    std::map<QString, BoxStyle> createMapDefinesClass(const ConfigBoxes &config) const;
-
-    void setTitleIfTextUnset(SlideList const& slides);
-    void applyJSONGeometries(ConfigBoxes const& config);
-    void applyJSONToBox(Slide::Ptr slide, Box::Ptr box, ConfigBoxes const& config) const;
-
+    // positions of the slides that can use the class with the key
+    std::vector<int> const& classUsers(QString const& key);
 
 private:
     SlideList mSlides;
     std::shared_ptr<Template> mTemplate;
+    // the classes defined by the boxes with the argument defineclass
+    std::shared_ptr<DefinedClasses const> mDefinedClasses = std::make_shared<DefinedClasses const>();
+    std::shared_ptr<ConfigBoxes const> mConfiguration;
+    // positions of the slides with boxes that can use a class, by the key of the class,
+    // built by restyleBox when it is needed
+    std::optional<std::map<QString, std::vector<int>>> mClassUsers;
+    // cascade of the slides that are not built yet, restyleBox replaces it
+    std::shared_ptr<std::shared_ptr<StyleCascade const>> mCascade;
 };
 
 #endif // PRESENTATIONDATA_H
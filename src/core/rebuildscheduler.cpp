@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "rebuildscheduler.h"
+
+#include <algorithm>
+
+namespace {
+// rebuilds faster than this are started right away
+int const instantRebuildTime = 30;
+// longest time to collect changes, bounds the latency for very large documents
+int const maximalDelay = 1000;
+}
+
+RebuildScheduler::RebuildScheduler(QObject *parent)
+    : QObject(parent)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout,
+            this, &RebuildScheduler::start);
+}
+
+void RebuildScheduler::schedule() {
+    mPending = true;
+    // the timer is not restarted, so that continuous typing still refreshes
+    if(mRunning || mTimer.isActive()) {
+        return;
+    }
+    mTimer.start(delay());
+}
+
+void RebuildScheduler::rebuildFinished() {
+    if(!mRunning) {
+        return;
+    }
+    mRunning = false;
+    auto const cost = int(mRebuildTime.elapsed());
+    mCost = mCost == 0 ? cost : (mCost + cost) / 2;
+    if(mPending) {
+        mTimer.start(delay());
+    }
+}
+
+void RebuildScheduler::reset() {
+    mTimer.stop();
+    mRunning = false;
+    mPending = false;
+    mCost = 0;
+}
+
+void RebuildScheduler::start() {
+    mPending = false;
+    mRunning = true;
+    mRebuildTime.start();
+    Q_EMIT rebuildRequested();
+}
+
+int RebuildScheduler::delay() const {
+    if(mCost < instantRebuildTime) {
+        return 0;
+    }
+    return std::min(mCost, maximalDelay);
+}
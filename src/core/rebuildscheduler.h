@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef REBUILDSCHEDULER_H
+#define REBUILDSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// Decides when the presentation is rebuilt after the input changed. Only one
+// rebuild runs at a time, changes during a rebuild are collected and start
+// the next one when it is done. If the last rebuilds were slow, changes are
+// collected for about the time a rebuild takes, so that typing in a large
+// document does not start a rebuild for every key.
+class RebuildScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    RebuildScheduler(QObject *parent = nullptr);
+
+    // call on every change of the input
+    void schedule();
+    // call when the result of the rebuild is shown, also if it failed
+    void rebuildFinished();
+    // the running rebuild is dropped, e.g. for a new document
+    void reset();
+
+Q_SIGNALS:
+    void rebuildRequested();
+
+private:
+    void start();
+    // time to wait before the next rebuild
+    int delay() const;
+
+private:
+    QTimer mTimer;
+    QElapsedTimer mRebuildTime;
+    bool mRunning = false;
+    bool mPending = false;
+    // average time of the last rebuilds in ms
+    int mCost = 0;
+};
+
+#endif // REBUILDSCHEDULER_H
@@ -5,6 +5,9 @@
 */
 
 #include "slide.h"
+#include "utils.h"
+
+#include <utility>
 
 Slide::Slide()
     : mId{""}
@@ -25,21 +28,81 @@ Slide::Slide(const QString &id, const PresentationContext &context, int line)
 {
 }
 
+Slide::Ptr Slide::clone() const {
+    auto slide = std::make_shared<Slide>(*this);
+    slide->mBoxes = copy(mBoxes);
+    slide->mTemplateBoxes = copy(mTemplateBoxes);
+    return slide;
+}
+
+Slide::Ptr Slide::lazyCopy(std::shared_ptr<Slide const> parsedSlide, int lineOffset) {
+    auto slide = std::make_shared<Slide>(parsedSlide->mId, parsedSlide->mContext, parsedSlide->mLine + lineOffset);
+    slide->mClass = parsedSlide->mClass;
+    slide->mDefaultStyle = parsedSlide->mDefaultStyle;
+    slide->mDefinesClass = parsedSlide->mDefinesClass;
+    slide->mOutdated = parsedSlide->mOutdated;
+    slide->mParsedSlide = std::move(parsedSlide);
+    slide->mLineOffset = lineOffset;
+    return slide;
+}
+
+void Slide::setStyle(std::function<void(Slide&)> style) {
+    mStyle = std::move(style);
+}
+
+bool Slide::built() const {
+    return (!mParsedSlide || mBoxesCopied) && !mStyle;
+}
+
+Box::List const& Slide::parsedBoxes() const {
+    if(mParsedSlide) {
+        return mParsedSlide->mBoxes;
+    }
+    return mBoxes;
+}
+
+void Slide::build() const {
+    if(built()) {
+        return;
+    }
+    // the slides are created as non const objects, only the access to the boxes is const
+    auto& slide = const_cast<Slide&>(*this);
+    // the parsed slide is kept to compare it with the next version of the slide
+    if(mParsedSlide && !mBoxesCopied) {
+        slide.mBoxesCopied = true;
+        slide.mBoxes = copy(mParsedSlide->mBoxes);
+        for(auto const& box: slide.mBoxes) {
+            box->setLine(box->line() + mLineOffset);
+            for(auto & property: box->properties()) {
+                property.second.mLine += mLineOffset;
+            }
+        }
+    }
+    // reset before styling, the style accesses the boxes
+    if(auto const style = std::exchange(slide.mStyle, nullptr)) {
+        style(slide);
+    }
+}
+
 const Box::List &Slide::boxes() const
 {
+    build();
     return mBoxes;
 }
 
 void Slide::appendBox(std::shared_ptr<Box> box)
 {
+    build();
     mBoxes.push_back(box);
 }
 
 void Slide::setBoxes(std::vector<std::shared_ptr<Box>> boxes){
+    build();
     mBoxes = boxes;
 }
 
 bool Slide::empty() {
+    build();
     return (mBoxes.empty() && mTemplateBoxes.empty());
 }
 
@@ -76,14 +139,17 @@ bool Slide::containsBox(const QString &id) const{
 }
 
 void Slide::setTemplateBoxes(Box::List boxes){
-    mTemplateBoxes = boxes;
+    build();
+    mTemplateBoxes = std::move(boxes);
 }
 
 void Slide::appendTemplateBoxes(Box::Ptr box){
+    build();
     mTemplateBoxes.push_back(box);
 }
 
-Box::List Slide::templateBoxes() const{
+Box::List const& Slide::templateBoxes() const{
+    build();
     return mTemplateBoxes;
 }
 
@@ -100,10 +166,11 @@ Variables& Slide::variables() {
 }
 
 void Slide::setVariable(QString const& name, QString const& value){
-    mContext.mVariables[name] = value;
+    mContext.mVariables.set(name, value);
 }
 
 int Slide::numberPauses() const {
+    build();
     if(mBoxes.empty()) {
         return 1;
     }
@@ -115,6 +182,10 @@ int Slide::line() const {
     return mLine;
 }
 
+void Slide::setLine(int line) {
+    mLine = line;
+}
+
 void Slide::setSlideClass(QString const& slideClass) {
     mClass = slideClass;
 }
@@ -135,21 +206,11 @@ QString Slide::definesClass() const {
 }
 
 QString Slide::valueOfVariable(const QString &variable) const {
-    auto const value = variables().find(variable);
-    if(value != variables().end()) {
-        return value->second;
-    }
-    return {};
+    return variables().value(variable).value_or(QString());
 }
 
 std::optional<QString> Slide::removeVariable(QString const& variable) {
-    auto itVariable = mContext.mVariables.find(variable);
-    if(itVariable == mContext.mVariables.end()) {
-        return {};
-    }
-    auto value = itVariable->second;
-    mContext.mVariables.erase(itVariable);
-    return value;
+    return mContext.mVariables.remove(variable);
 }
 
 int Slide::pagenumber() const {
@@ -158,12 +219,12 @@ int Slide::pagenumber() const {
 
 void Slide::setTotalNumberPages(int pages) {
     mContext.mTotalnumberofPages = pages;
-    mContext.mVariables["%{totalpages}"] = QString::number(pages);
+    mContext.mVariables.set("%{totalpages}", QString::number(pages));
 }
 
 void Slide::setPagenumber(int pagenumber) {
     mContext.mPagenumber = pagenumber;
-    mContext.mVariables["%{pagenumber}"] = QString::number(pagenumber);
+    mContext.mVariables.set("%{pagenumber}", QString::number(pagenumber));
 }
 
 void Slide::setTableOfContents(TableOfContent tableofcontent) {
@@ -173,3 +234,11 @@ void Slide::setTableOfContents(TableOfContent tableofcontent) {
 PresentationContext const& Slide::context() const {
     return mContext;
 }
+
+void Slide::setOutdated(bool outdated) {
+    mOutdated = outdated;
+}
+
+bool Slide::outdated() const {
+    return mOutdated;
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <vector>
+#include <functional>
 #include <QVariant>
 #include "box.h"
 
@@ -19,6 +20,20 @@ public:
     Slide(QString const& id, int line);
     Slide(QString const& id, PresentationContext const& variables, int line);
 
+    // Copy of the slide with copies of its boxes
+    Slide::Ptr clone() const;
+
+    // Copy of a parsed slide that copies the boxes on the first access to them, e.g. when
+    // the slide is painted or exported. The lines are shifted by lineOffset.
+    static Slide::Ptr lazyCopy(std::shared_ptr<Slide const> parsedSlide, int lineOffset);
+    // Styling of the boxes that runs before the next access to them
+    void setStyle(std::function<void(Slide&)> style);
+    // false while the boxes are not copied or not styled
+    bool built() const;
+    // Boxes as they were parsed, also after the slide was built. Only their ids and
+    // properties are meant to be read.
+    Box::List const& parsedBoxes() const;
+
     // Access contained boxes
     void setBoxes(std::vector<std::shared_ptr<Box>> boxes);
     void appendBox(std::shared_ptr<Box> box);
@@ -33,11 +48,12 @@ public:
 
     // line in which the "\slide" comment is written in the input file
     int line() const;
+    void setLine(int line);
 
     // Template boxes are rendered in the background of the slide.
     void setTemplateBoxes(Box::List boxes);
     void appendTemplateBoxes(Box::Ptr box);
-    Box::List templateBoxes() const;
+    Box::List const& templateBoxes() const;
 
     // The slide ID is the string after the "\slide" command, and is used to track
     // the slide when the document changes.
@@ -64,6 +80,14 @@ public:
     void setTableOfContents(TableOfContent tableofcontent);
     PresentationContext const& context() const;
 
+    // the text of the slide has an error, the slide shows the last version without error
+    void setOutdated(bool outdated);
+    bool outdated() const;
+
+private:
+    // copies and styles the boxes if this did not happen yet
+    void build() const;
+
 private:
     Box::List mBoxes;
     Box::List mTemplateBoxes;
@@ -73,6 +97,11 @@ private:
     int mLine;
     BoxStyle mDefaultStyle;
     QString mDefinesClass;
+    bool mOutdated = false;
+    std::shared_ptr<Slide const> mParsedSlide;
+    bool mBoxesCopied = false;
+    int mLineOffset = 0;
+    std::function<void(Slide&)> mStyle;
 };
 
 Q_DECLARE_METATYPE(Slide::Ptr)
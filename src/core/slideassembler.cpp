@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "slideassembler.h"
+
+#include <QDate>
+
+SlideAssembler::SlideAssembler(QString const& directory)
+    : mDirectory(directory)
+{
+}
+
+std::optional<ParserError> SlideAssembler::append(ParsedChunk const& chunk, int line, bool outdated,
+                                                  IncludeHandler const& includeHandler) {
+    if(chunk.mParserError) {
+        auto error = chunk.mParserError.value();
+        error.line += line;
+        return error;
+    }
+    if(!chunk.mPreamble.templateName.isEmpty()) {
+        mPreamble = {chunk.mPreamble.templateName, chunk.mPreamble.line + line};
+    }
+    for(auto const& parsedSlide: chunk.mSlideList.vector) {
+        // the boxes are copied with the lines counted from the start of the input when they are used
+        auto slide = Slide::lazyCopy(parsedSlide, line);
+        slide->setOutdated(outdated);
+        if(mSlideList.findSlide(slide->id())) {
+            return ParserError{QString("Slide id %1 already exists.").arg(slide->id()), slide->line()};
+        }
+        for(auto const& box: slide->parsedBoxes()) {
+            auto const idProperty = box->properties().find(PropertyId::Id);
+            if(idProperty == box->properties().end() || idProperty->second.mValue.isEmpty()) {
+                mGeneratedBoxIds.insert(box->id());
+            }
+            else if(mGeneratedBoxIds.find(box->id()) != mGeneratedBoxIds.end()) {
+                return ParserError{"Duplicated box ID.", box->line()};
+            }
+        }
+
+        // variables set before the slide, the slides until the next assignment share them
+        mVariables.share();
+        slide->setVariables(mVariables);
+        mSlideList.appendSlide(slide);
+        slide->setPagenumber(mSlideList.numberSlides());
+        if(!mVariables.contains("%{date}")){
+            slide->setVariable("%{date}", QDate::currentDate().toString());
+        }
+        if(!mVariables.contains("%{resourcepath}")){
+            slide->setVariable("%{resourcepath}", mDirectory);
+        }
+        if(!mVariables.contains("%{section}")) {
+            mVariables.set("%{section}", "");
+        }
+    }
+    auto include = chunk.mIncludes.begin();
+    auto const appendIncludes = [&](int assignments) -> std::optional<ParserError> {
+        for(; include != chunk.mIncludes.end() && include->assignmentsBefore <= assignments; include++) {
+            auto shifted = *include;
+            shifted.line += line;
+            if(!includeHandler) {
+                return includeNotSupported(shifted);
+            }
+            if(auto const error = includeHandler(shifted)) {
+                return error;
+            }
+        }
+        return {};
+    };
+    for(std::size_t i = 0; i < chunk.mVariableAssignments.size(); i++) {
+        if(auto const error = appendIncludes(int(i))) {
+            return error;
+        }
+        auto const& assignment = chunk.mVariableAssignments[i];
+        mVariables.set(assignment.name, assignment.value);
+    }
+    return appendIncludes(int(chunk.mVariableAssignments.size()));
+}
+
+ParserOutput SlideAssembler::output() {
+    auto const totalNumberOfPages = mSlideList.numberSlides();
+    for (auto const & slide : mSlideList.vector) {
+        slide->setTotalNumberPages(totalNumberOfPages);
+    }
+    return ParserOutput(std::move(mSlideList), mPreamble);
+}
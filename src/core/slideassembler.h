@@ -0,0 +1,43 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef SLIDEASSEMBLER_H
+#define SLIDEASSEMBLER_H
+
+#include "parser.h"
+
+#include <functional>
+#include <set>
+
+// Puts the slides of the parsed chunks together in the order of the input. The
+// slides are copied lazily with the lines counted from the beginning of the input, and
+// the things that depend on the slides before are set: variables, page numbers
+// and the checks for unique ids.
+class SlideAssembler
+{
+public:
+    SlideAssembler(QString const& directory);
+
+    // appends the slides of an included file, it is called between the variable assignments of the chunk
+    using IncludeHandler = std::function<std::optional<ParserError>(Include const& include)>;
+
+    // line is the line of the chunk in the input, outdated marks its slides.
+    // Without a handler an \include is an error.
+    std::optional<ParserError> append(ParsedChunk const& chunk, int line, bool outdated = false,
+                                      IncludeHandler const& includeHandler = {});
+    // sets the total number of pages, the slides are moved into the output
+    ParserOutput output();
+
+private:
+    QString mDirectory;
+    SlideList mSlideList;
+    Preamble mPreamble{"", 0};
+    Variables mVariables;
+    // ids generated by the chunks before, an id given by the user must not collide with them
+    std::set<QString> mGeneratedBoxIds;
+};
+
+#endif // SLIDEASSEMBLER_H
@@ -0,0 +1,407 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "slidelistbuilder.h"
+#include "box.h"
+#include "imagebox.h"
+#include "markdowntextbox.h"
+#include "plaintextbox.h"
+#include "codebox.h"
+#include "geometrybox.h"
+#include "latexbox.h"
+#include "tableofcontentsbox.h"
+#include "sectionpreviewbox.h"
+#include "utils.h"
+
+#include <QDate>
+#include <set>
+
+namespace  {
+
+    QString addBracketsToVariable(QString variable) {
+        return "%{" + variable + "}";
+    }
+
+    bool multilineText(QString text) {
+        return text.contains("\n");
+    }
+
+    QStringView removeSpacesAtBack(QStringView text) {
+        while(!text.isEmpty() && text.back() ==' ') {
+            text.chop(1);
+        }
+        return text;
+    }
+
+    QStringView removeBrackets(QStringView text) {
+        return text.mid(2, text.size() - 4);
+    }
+
+    void setClassIfEmpty(QString const& boxClass, PropertyEntry const& defaultClassEntry, Box::Properties & properties) {
+        if(boxClass.isEmpty()) {
+            properties[PropertyId::Class] = defaultClassEntry;
+        }
+    }
+
+    QString getValueAsQStringForProperty(PropertyId property, Box::Properties & properties) {
+        if(properties.find(property) != properties.end()) {
+            return properties.find(property)->second.mValue;
+        }
+        return {};
+    }
+
+}
+
+void SlideListBuilder::setCommand(QStringView command) {
+    mCommand = command.toString();
+}
+
+void SlideListBuilder::setText(QStringView text) {
+    mText = removeSpacesAtBack(text).toString();
+}
+
+void SlideListBuilder::setTextInBracket(QStringView text) {
+    mText = removeBrackets(text).toString();
+}
+
+void SlideListBuilder::finishBox(int line) {
+    // read out values
+    auto const command = mCommand;
+    auto const text = mText;
+    mCommand = "";
+    mText = "";
+
+    if(command.isEmpty()) {
+        throw ParserError{"Expected command.", line};
+    }
+
+    if(command == "slide"){
+        newSlide(text, line);
+        mLastCommandSetVariable = false;
+        mLastCommandInclude = false;
+        mInPreamble = false;
+        mProperties.clear();
+        return;
+    }
+
+    if(mInPreamble) {
+        readPreambleCommand(command, text, line);
+        return;
+    }
+
+    if(mSlideList.empty()){
+        throw ParserError{"Expected \\slide", line};
+        return;
+    }
+
+    if(command == "section") {
+        mLastCommandSetVariable = true;
+        setSection(text, line);
+        return;
+    }
+    if(command == "subsection") {
+        mLastCommandSetVariable = true;
+        setSubsection(text, line);
+        return;
+    }
+    else if(command == "setvar"){
+        mLastCommandSetVariable = true;
+        setVariable(text, line);
+        return;
+    }
+    else if(command == "include") {
+        mLastCommandInclude = true;
+        addInclude(text, line);
+        return;
+    }
+    else {
+        mLastCommandSetVariable = false;
+    }
+    static auto const boxInstructions = std::set<QString>{"text", "image", "body", "title", "blindtext", "plaintext", "code", "geometry", "latex", "tableofcontents", "sectionpreview"};
+    if(boxInstructions.find(command) != boxInstructions.end()) {
+        if(mLastCommandSetVariable) {
+            throw ParserError{"Command \\setvar only valid outside a slide.", line};
+        }
+        // the slides of the included file come before the box
+        if(mLastCommandInclude) {
+            throw ParserError{"Command \\include only valid outside a slide.", line};
+        }
+
+        createNewBox(command, text, line);
+        mProperties.clear();
+        return;
+    }
+
+
+    if(command == "pause"){
+        if(mParsingTemplate) {
+            throw ParserError{QString("Invalid command '%1' in template").arg(command), line};
+        }
+        applyPause(text);
+        return;
+    }
+
+
+    throw ParserError{QString("Invalid command '%1'").arg(command), line};
+}
+
+
+void SlideListBuilder::addProperty(QStringView property, QStringView value, int line) {
+    if(property.isEmpty()) {
+        throw ParserError{"Expected property.", line};
+    }
+    if(value.isEmpty()) {
+        throw ParserError{"Expected value.", line};
+    }
+    auto const id = propertyId(property);
+    if(!id) {
+        throw ParserError{QString("Invalid Argument %1.").arg(property), line};
+    }
+    // the properties are converted when the slide is styled, this can happen after the build
+    // while the slide is painted, so invalid values are reported here
+    try {
+        BoxStyle style;
+        applyProperty(id.value(), value.toString(), line, style);
+    }  catch (PorpertyConversionError const& error) {
+        throw ParserError{error.message, error.line};
+    }
+    mProperties[id.value()] = {value.toString(), line};
+}
+
+void SlideListBuilder::newSlide(QString id, int line) {
+    if(multilineText(id)) {
+        throw ParserError {"One line text expected.", line};
+    }
+//  reset and create new slide
+    mPauseCount = 0;
+    if(id.isEmpty()) {
+        throw ParserError{QString("Slide id is missing.").arg(id), line};
+    }
+    if(mSlideList.findSlide(id)) {
+        throw ParserError{QString("Slide id %1 already exists.").arg(id), line};
+    }
+    mSlideList.appendSlide(std::make_shared<Slide>(id, line));
+    if(mProperties.find(PropertyId::Class) != mProperties.end()) {
+        mSlideList.lastSlide()->setSlideClass(mProperties.find(PropertyId::Class)->second.mValue);
+    }
+    if (mProperties.find(PropertyId::Defineclass) != mProperties.end()) {
+        mSlideList.lastSlide()->setDefinesClass(mProperties.find(PropertyId::Defineclass)->second.mValue);
+    }
+    // set variables, the slides until the next assignment share them
+    mVariables.share();
+    mSlideList.lastSlide()->setVariables(mVariables);
+    mSlideList.lastSlide()->setPagenumber(mSlideList.vector.size());
+    if(!mVariables.contains("%{date}")){
+        mSlideList.lastSlide()->setVariable("%{date}", QDate::currentDate().toString());
+    }
+    if(!mVariables.contains("%{resourcepath}")){
+        mSlideList.lastSlide()->setVariable("%{resourcepath}", mResourcepath);
+    }
+    if(!mVariables.contains(addBracketsToVariable("section"))) {
+        mVariables.set(addBracketsToVariable("section"), "");
+    }
+    mProperties.clear();
+}
+
+void SlideListBuilder::setVariable(QString text, int line) {
+    auto list = QString(text).split(" ");
+    auto const variable = list[0];
+    list.removeFirst();
+    auto const value = list.join(" ");
+    mVariables.set(addBracketsToVariable(variable), value);
+    mVariableAssignments.push_back({addBracketsToVariable(variable), value});
+}
+
+void SlideListBuilder::setSection(QString section, int line) {
+    mVariables.set(addBracketsToVariable("section"), section);
+    mVariableAssignments.push_back({addBracketsToVariable("section"), section});
+}
+
+void SlideListBuilder::setSubsection(QString subsection, int line) {
+    mVariables.set(addBracketsToVariable("subsection"), subsection);
+    mVariableAssignments.push_back({addBracketsToVariable("subsection"), subsection});
+}
+
+void SlideListBuilder::createNewBox(QString command, QString text, int line) {
+    if(!text.isEmpty()) {
+        mProperties[PropertyId::Text] = {text, line};
+    }
+    std::shared_ptr<Box> box;
+    QString boxClass;
+    if(mProperties.find(PropertyId::Class) != mProperties.end()) {
+        boxClass = mProperties.find(PropertyId::Class)->second.mValue;
+    }
+    if(command == "text"){
+        box = std::make_shared<MarkdownTextBox>();
+    }
+    else if(command == "image"){
+        if(multilineText(text)) {
+            throw ParserError {"One line text expected.", line};
+        }
+        box = std::make_shared<ImageBox>();
+        setClassIfEmpty(boxClass, {"image", line}, mProperties);
+    }
+    else if(command == "code"){
+        box = std::make_shared<CodeBox>();
+        setClassIfEmpty(boxClass, {"code", line}, mProperties);
+    }
+    else if(command == "body"){
+        box = std::make_shared<MarkdownTextBox>();
+        mProperties[PropertyId::Class] = {"body", line};
+    }
+    else if(command == "title"){
+        box = std::make_shared<MarkdownTextBox>();
+        mProperties[PropertyId::Class] = {"title", line};
+    }
+    else if (command == "blindtext") {
+        text = "Lorem ipsum dolor sit amet, consectetur adipisici elit, sed eiusmod tempor incidunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquid ex ea commodi consequat. Quis aute iure reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint obcaecat cupiditat non proident, sunt in culpa qui officia deserunt mollit anim id est laborum.";
+        box = std::make_shared<MarkdownTextBox>();
+    }
+    else if (command == "plaintext") {
+        box = std::make_shared<PlainTextBox>();
+    }
+    else if (command == "geometry") {
+        box = std::make_shared<GeometryBox>();
+    }
+    else if (command == "latex") {
+        box = std::make_shared<LaTeXBox>();
+        setClassIfEmpty(boxClass, {"body", line}, mProperties);
+    }
+    else if (command == "tableofcontents") {
+        box = std::make_shared<TableofContentsBox>();
+        mProperties[PropertyId::Class] = {"tableofcontents", line};
+    }
+    else if (command == "sectionpreview") {
+        box = std::make_shared<SectionPreviewBox>();
+        mProperties[PropertyId::Class] = {"sectionpreview", line};
+    }
+
+    auto newBoxClass = getValueAsQStringForProperty(PropertyId::Class, mProperties);
+    if(newBoxClass.isEmpty()) {
+        newBoxClass = "default";
+    }
+    auto id = getValueAsQStringForProperty(PropertyId::Id, mProperties);
+    if(id.isEmpty()) {
+        id = generateId(command, newBoxClass);
+    }
+    else if (mBoxIds.contains(id)) {
+        throw ParserError {"Duplicated box ID.", line};
+    }
+
+    box->setProperties(mProperties);
+
+    box->setId(id);
+    box->setLine(line);
+    if(mProperties.find(PropertyId::Defineclass) != mProperties.end()) {
+        box->setDefinesClass(mProperties.find(PropertyId::Defineclass)->second.mValue);
+    }
+    box->setPauseCounter(mPauseCount);
+    if(!getValueAsQStringForProperty(PropertyId::Text, mProperties).isEmpty()) {
+        box->style().mText = getValueAsQStringForProperty(PropertyId::Text, mProperties);
+    }
+
+    mSlideList.appendBox(box);
+}
+
+
+QString SlideListBuilder::generateId(QString type, QString boxclass) {
+    auto const prefix = "intern-" + mSlideList.lastSlide()->id() + "-" + type + "-" + boxclass + "-";
+    // the counter continues where the last id with the same prefix stopped
+    auto& boxCounter = mIdCounters[prefix];
+    auto id = prefix + QString::number(boxCounter);
+    while(mBoxIds.contains(id)) {
+        boxCounter++;
+        id = prefix + QString::number(boxCounter);
+    }
+    boxCounter++;
+    mBoxIds.insert(id);
+    return id;
+}
+
+SlideList SlideListBuilder::takeSlides() {
+    return std::move(mSlideList);
+}
+
+Preamble SlideListBuilder::preamble() const {
+    return mPreamble;
+}
+
+std::vector<VariableAssignment> const& SlideListBuilder::variableAssignments() const {
+    return mVariableAssignments;
+}
+
+void SlideListBuilder::setDirectory(QString directory) {
+    mResourcepath = directory;
+}
+
+void SlideListBuilder::setParseTemplate(bool isTemplate) {
+    mParsingTemplate = isTemplate;
+}
+
+void SlideListBuilder::applyPause(QString text) {
+    mPauseCount++;
+
+    if(mSlideList.lastSlide()->boxes().empty()) {
+        return;
+    }
+    auto const lastTextBox = std::dynamic_pointer_cast<TextBox>(mSlideList.lastSlide()->boxes().back());
+    if(!lastTextBox) {
+        return;
+    }
+    lastTextBox->setPauseMode(PauseDisplayMode::onlyInPause);
+
+    auto box = std::static_pointer_cast<TextBox>(lastTextBox->clone());
+    if(!text.isEmpty() && !box->text().isEmpty())
+        text.insert(0, '\n');
+    box->setProperty(PropertyId::Text, {lastTextBox->text() + text, box->line()});
+    box->style().mText = lastTextBox->text() + text;
+    box->setPauseCounter(mPauseCount);
+    lastTextBox->setId(lastTextBox->configId() + "-" + mPauseCount);
+    lastTextBox->setConfigId(box->id());
+    box->setPauseMode(PauseDisplayMode::fromPauseOn);
+    mSlideList.appendBox(box);
+}
+
+void SlideListBuilder::finish() {
+    auto const totalNumberOfPages = mSlideList.numberSlides();
+    for (auto const & slide : mSlideList.vector) {
+        slide->setTotalNumberPages(totalNumberOfPages);
+    }
+}
+
+void SlideListBuilder::readPreambleCommand(QString command, QString text, int line) {
+    if(command == "usetemplate") {
+        if(!mParsingTemplate) {
+            mPreamble = Preamble{text, line};
+        }
+        else {
+            throw ParserError{QString("Unexpected command %1 in template.").arg(command), line};
+        }
+    }
+    else if(command == "setvar") {
+        setVariable(text, line);
+    }
+    else if(command == "include") {
+        addInclude(text, line);
+    }
+    else {
+        throw ParserError{QString("Unexpected command %1.").arg(command), line};
+    }
+}
+
+void SlideListBuilder::addInclude(QString fileName, int line) {
+    if(mParsingTemplate) {
+        throw ParserError{"Unexpected command include in template.", line};
+    }
+    if(fileName.isEmpty()) {
+        throw ParserError{"Expected file name after \\include.", line};
+    }
+    mIncludes.push_back({fileName, line, int(mVariableAssignments.size())});
+}
+
+std::vector<Include> const& SlideListBuilder::includes() const {
+    return mIncludes;
+}
@@ -0,0 +1,111 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef SLIDELISTBUILDER_H
+#define SLIDELISTBUILDER_H
+
+#include "slide.h"
+#include "presentationdata.h"
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+struct ParserError{
+    QString message;
+    int line;
+};
+
+struct Preamble {
+    QString templateName;
+    int line;
+};
+
+// a \setvar, \section or \subsection command in the order they appear in the input
+struct VariableAssignment {
+    QString name;
+    QString value;
+};
+
+// an \include command, its slides come after the first assignmentsBefore variable assignments
+struct Include {
+    QString fileName;
+    int line;
+    int assignmentsBefore;
+};
+
+// Creates the slides from the commands of the input. The parsers report every
+// command with its properties and text and call finishBox at the end of it.
+class SlideListBuilder
+{
+public:
+    SlideListBuilder() = default;
+
+    // parts of the current command, the views only need to be valid during the call
+    void setCommand(QStringView command);
+    // text of the paragraph, spaces at the end are removed
+    void setText(QStringView text);
+    // text of the paragraph including the brackets \{ \}
+    void setTextInBracket(QStringView text);
+    void addProperty(QStringView property, QStringView value, int line);
+    // throws ParserError
+    void finishBox(int line);
+    // call after the last command
+    void finish();
+
+    void setDirectory(QString directory);
+    void applyPause(QString text);
+
+//    acess varibles
+    // moves the slides out of the builder, call after finish
+    SlideList takeSlides();
+    Preamble preamble() const;
+    void setParseTemplate(bool isTemplate);
+    std::vector<VariableAssignment> const& variableAssignments() const;
+    std::vector<Include> const& includes() const;
+
+private:
+    void newSlide(QString id, int line);
+
+    void readPreambleCommand(QString command, QString text, int line);
+
+//    create new Box
+    void createNewBox(QString command, QString text, int line);
+
+    void setVariable(QString text, int line);
+    void setSection(QString section, int line);
+    void setSubsection(QString subsection, int line);
+    void addInclude(QString fileName, int line);
+    QString generateId(QString type, QString boxclass);
+
+private:
+    SlideList mSlideList;
+    // generated box ids and the next number for each prefix of them
+    QSet<QString> mBoxIds;
+    QHash<QString, int> mIdCounters;
+
+    QString mResourcepath;
+
+    bool mParsingTemplate = false;
+    int mPauseCount = 0;
+    Preamble mPreamble{"", 0};
+
+    bool mLastCommandSetVariable = false;
+    bool mLastCommandInclude = false;
+    bool mInPreamble = true;
+
+    QString mText;
+    QString mCommand;
+
+    // style set by the properties in the squared brackets
+    Box::Properties mProperties;
+    // varaibles set by setvalue
+    Variables mVariables;
+    std::vector<VariableAssignment> mVariableAssignments;
+    std::vector<Include> mIncludes;
+};
+
+#endif // SLIDELISTBUILDER_H
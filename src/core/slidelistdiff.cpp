@@ -0,0 +1,222 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "slidelistdiff.h"
+#include "presentationdata.h"
+
+#include <QHash>
+#include <algorithm>
+#include <typeinfo>
+
+namespace {
+
+// position in oldIds for every id of newIds, -1 if there is none. An id that
+// occurs more than once is matched in the order of the lists.
+std::vector<int> matchIds(std::vector<QString> const& oldIds, std::vector<QString> const& newIds) {
+    QHash<QString, std::vector<int>> positions;
+    for(int i = int(oldIds.size()) - 1; i >= 0; i--) {
+        positions[oldIds[i]].push_back(i);
+    }
+    std::vector<int> matched;
+    matched.reserve(newIds.size());
+    for(auto const& id: newIds) {
+        auto const found = positions.find(id);
+        if(found == positions.end() || found->empty()) {
+            matched.push_back(-1);
+            continue;
+        }
+        matched.push_back(found->back());
+        found->pop_back();
+    }
+    return matched;
+}
+
+// the matched entries that are not in the longest subsequence that kept its order
+std::vector<int> movedPositions(std::vector<int> const& oldPositions) {
+    // tails holds the last entry of the best subsequence of each length
+    std::vector<int> tails;
+    std::vector<int> previous(oldPositions.size(), -1);
+    for(int i = 0; i < int(oldPositions.size()); i++) {
+        if(oldPositions[i] < 0) {
+            continue;
+        }
+        auto const tail = std::lower_bound(tails.begin(), tails.end(), oldPositions[i], [&oldPositions](int entry, int oldPosition){
+            return oldPositions[entry] < oldPosition;
+        });
+        if(tail != tails.begin()) {
+            previous[i] = *(tail - 1);
+        }
+        if(tail == tails.end()) {
+            tails.push_back(i);
+        }
+        else {
+            *tail = i;
+        }
+    }
+    std::vector<bool> kept(oldPositions.size(), false);
+    for(int i = tails.empty() ? -1 : tails.back(); i >= 0; i = previous[i]) {
+        kept[i] = true;
+    }
+    std::vector<int> moved;
+    for(int i = 0; i < int(oldPositions.size()); i++) {
+        if(oldPositions[i] >= 0 && !kept[i]) {
+            moved.push_back(i);
+        }
+    }
+    return moved;
+}
+
+std::vector<QString> slideIds(SlideList const& slides) {
+    std::vector<QString> ids;
+    ids.reserve(slides.vector.size());
+    for(auto const& slide: slides.vector) {
+        ids.push_back(slide->id());
+    }
+    return ids;
+}
+
+std::vector<QString> boxIds(Box::List const& boxes) {
+    std::vector<QString> ids;
+    ids.reserve(boxes.size());
+    for(auto const& box: boxes) {
+        ids.push_back(box->id());
+    }
+    return ids;
+}
+
+// the lines are not compared, they change with every line inserted above the box
+bool sameBox(Box const& oldBox, Box const& newBox) {
+    auto const sameEntry = [](auto const& a, auto const& b){
+        return a.first == b.first && a.second.mValue == b.second.mValue;
+    };
+    return typeid(oldBox) == typeid(newBox)
+            && oldBox.style().mText == newBox.style().mText
+            && oldBox.pauseCounter().mCount == newBox.pauseCounter().mCount
+            && oldBox.pauseCounter().mDisplayMode == newBox.pauseCounter().mDisplayMode
+            && std::equal(oldBox.properties().begin(), oldBox.properties().end(),
+                          newBox.properties().begin(), newBox.properties().end(), sameEntry);
+}
+
+SlideListDiff::BoxChanges diffBoxes(Box::List const& oldBoxes, Box::List const& newBoxes) {
+    SlideListDiff::BoxChanges changes;
+    // the boxes of a slide that was not parsed again
+    if(&oldBoxes == &newBoxes) {
+        return changes;
+    }
+    auto const oldPositions = matchIds(boxIds(oldBoxes), boxIds(newBoxes));
+    std::vector<bool> matched(oldBoxes.size(), false);
+    for(std::size_t i = 0; i < newBoxes.size(); i++) {
+        if(oldPositions[i] < 0) {
+            changes.inserted.push_back(newBoxes[i]->id());
+            continue;
+        }
+        matched[oldPositions[i]] = true;
+        if(!sameBox(*oldBoxes[oldPositions[i]], *newBoxes[i])) {
+            changes.modified.push_back(newBoxes[i]->id());
+        }
+    }
+    for(std::size_t i = 0; i < oldBoxes.size(); i++) {
+        if(!matched[i]) {
+            changes.removed.push_back(oldBoxes[i]->id());
+        }
+    }
+    // boxes that are painted in another order
+    for(auto const position: movedPositions(oldPositions)) {
+        changes.moved.push_back(newBoxes[position]->id());
+    }
+    return changes;
+}
+
+bool sameTableOfContents(TableOfContent const& oldTable, TableOfContent const& newTable) {
+    auto const sameSubsection = [](Subsection const& a, Subsection const& b){
+        return a.name == b.name && a.startPage == b.startPage && a.length == b.length;
+    };
+    auto const sameSection = [&sameSubsection](Section const& a, Section const& b){
+        return a.name == b.name && a.startPage == b.startPage && a.length == b.length
+                && std::equal(a.subsection.begin(), a.subsection.end(), b.subsection.begin(), b.subsection.end(), sameSubsection);
+    };
+    return std::equal(oldTable.sections.begin(), oldTable.sections.end(),
+                      newTable.sections.begin(), newTable.sections.end(), sameSection);
+}
+
+bool sameContext(PresentationContext const& oldContext, PresentationContext const& newContext) {
+    return oldContext.mPagenumber == newContext.mPagenumber
+            && oldContext.mTotalnumberofPages == newContext.mTotalnumberofPages
+            && oldContext.mVariables == newContext.mVariables
+            && sameTableOfContents(oldContext.mTableOfContent, newContext.mTableOfContent);
+}
+
+bool sameSlide(Slide const& oldSlide, Slide const& newSlide) {
+    return oldSlide.slideClass() == newSlide.slideClass()
+            && oldSlide.definesClass() == newSlide.definesClass()
+            && oldSlide.outdated() == newSlide.outdated()
+            && sameContext(oldSlide.context(), newSlide.context());
+}
+
+// the classes defined by the slide are used by the other slides
+bool definesClass(Slide const& slide) {
+    return std::any_of(slide.parsedBoxes().begin(), slide.parsedBoxes().end(), [](auto const& box){
+        return box->properties().find(PropertyId::Defineclass) != box->properties().end();
+    });
+}
+
+}
+
+bool SlideListDiff::changed(int position) const {
+    for(auto const* positions: {&inserted, &moved, &modified}) {
+        if(std::binary_search(positions->begin(), positions->end(), position)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SlideListDiff diffSlideLists(SlideList const& oldSlides, SlideList const& newSlides, bool restyled) {
+    SlideListDiff diff;
+    diff.oldPositions = matchIds(slideIds(oldSlides), slideIds(newSlides));
+
+    std::vector<bool> matched(oldSlides.vector.size(), false);
+    std::map<int, SlideListDiff::BoxChanges> boxChanges;
+    for(int i = 0; i < int(newSlides.vector.size()); i++) {
+        auto const oldPosition = diff.oldPositions[i];
+        auto const& newSlide = *newSlides.vector[i];
+        if(oldPosition < 0) {
+            diff.inserted.push_back(i);
+            restyled = restyled || definesClass(newSlide);
+            continue;
+        }
+        matched[oldPosition] = true;
+        auto const& oldSlide = *oldSlides.vector[oldPosition];
+        auto changes = diffBoxes(oldSlide.parsedBoxes(), newSlide.parsedBoxes());
+        if(!changes.empty() || !sameSlide(oldSlide, newSlide)) {
+            restyled = restyled || definesClass(oldSlide) || definesClass(newSlide);
+            boxChanges[i] = std::move(changes);
+        }
+    }
+    for(int i = 0; i < int(oldSlides.vector.size()); i++) {
+        if(!matched[i]) {
+            diff.removed.push_back(i);
+            restyled = restyled || definesClass(*oldSlides.vector[i]);
+        }
+    }
+    diff.moved = movedPositions(diff.oldPositions);
+
+    // a changed class can change every slide
+    for(int i = 0; i < int(newSlides.vector.size()); i++) {
+        if(diff.oldPositions[i] < 0) {
+            continue;
+        }
+        auto changes = boxChanges.find(i);
+        if(changes == boxChanges.end() && !restyled) {
+            continue;
+        }
+        diff.modified.push_back(i);
+        if(changes != boxChanges.end()) {
+            diff.boxChanges[i] = std::move(changes->second);
+        }
+    }
+    return diff;
+}
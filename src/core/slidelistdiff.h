@@ -0,0 +1,56 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef SLIDELISTDIFF_H
+#define SLIDELISTDIFF_H
+
+#include <QString>
+#include <map>
+#include <vector>
+
+struct SlideList;
+
+// Changes between two successive slide lists. The slides are matched by their id and
+// the boxes of a matched slide by their id, they are compared as they were parsed,
+// so that no slide has to be built for the comparison.
+struct SlideListDiff {
+    struct BoxChanges {
+        std::vector<QString> inserted;
+        std::vector<QString> removed;
+        std::vector<QString> moved;
+        std::vector<QString> modified;
+
+        bool empty() const {
+            return inserted.empty() && removed.empty() && moved.empty() && modified.empty();
+        }
+    };
+
+    // position in the old list for every slide of the new list, -1 for inserted slides
+    std::vector<int> oldPositions;
+    // all positions are sorted, inserted, moved and modified are positions in the new list
+    std::vector<int> inserted;
+    // positions in the old list
+    std::vector<int> removed;
+    // slides whose order relative to the other slides changed
+    std::vector<int> moved;
+    // slides that look different, e.g. because a box or the page number changed
+    std::vector<int> modified;
+    // changes of the boxes of the modified slides by position, a slide can be modified
+    // without changed boxes, e.g. if only its variables changed
+    std::map<int, BoxChanges> boxChanges;
+
+    bool empty() const {
+        return inserted.empty() && removed.empty() && moved.empty() && modified.empty();
+    }
+
+    // the slide at the position of the new list has to be painted again
+    bool changed(int position) const;
+};
+
+// with restyled all matched slides are modified, e.g. if the template or the configuration changed
+SlideListDiff diffSlideLists(SlideList const& oldSlides, SlideList const& newSlides, bool restyled = false);
+
+#endif // SLIDELISTDIFF_H
@@ -31,16 +31,16 @@ SlideRenderer::SlideRenderer(QPainter& painter)
 {
 }
 
-void SlideRenderer::paintSlide(Slide::Ptr slide) const {
+void SlideRenderer::paintSlide(Slide::Ptr const& slide) const {
     paintSlide(slide, slide->numberPauses());
 }
 
-void SlideRenderer::paintSlide(Slide::Ptr slide, int pauseCount) const {
+void SlideRenderer::paintSlide(Slide::Ptr const& slide, int pauseCount) const {
     if(slide->empty()) {
         return;
     }
-    auto const templateBoxes = slide->templateBoxes();
-    auto const context = slide->context();
+    auto const& templateBoxes = slide->templateBoxes();
+    auto const& context = slide->context();
     for(auto const& box: templateBoxes){
         box->drawContent(mPainter, context, mRenderHints);
     }
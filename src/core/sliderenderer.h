@@ -18,8 +18,8 @@ public:
     SlideRenderer(QPainter& painter);
 
 //    Painting Slide, if paintSlide(Slide::Ptr slide) is used every Box is painted
-    void paintSlide(Slide::Ptr slide) const;
-    void paintSlide(Slide::Ptr slide, int pauseCount) const;
+    void paintSlide(Slide::Ptr const& slide) const;
+    void paintSlide(Slide::Ptr const& slide, int pauseCount) const;
 
     void setRenderHints(PresentationRenderHints hints);
 
@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef SLIDESPLITTER_H
+#define SLIDESPLITTER_H
+
+#include <QStringView>
+#include <string_view>
+#include <vector>
+
+// part of the input, line is the line of its first character
+template<typename View>
+struct TextChunk {
+    View text;
+    int line;
+};
+
+namespace slidesplitter {
+
+// characters of the WORD token in potato.g4, the text is either UTF-16 or UTF-8
+template<typename Character>
+bool isWordCharacter(Character character) {
+    static auto const specialCharacters = std::string_view("-._#+/()");
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z')
+            || (character >= '0' && character <= '9')
+            || (character < 128 && specialCharacters.find(char(character)) != std::string_view::npos);
+}
+
+inline char16_t character(QStringView text, int position) {
+    return text[position].unicode();
+}
+
+inline unsigned char character(std::string_view text, std::size_t position) {
+    return static_cast<unsigned char>(text[position]);
+}
+
+inline QStringView slice(QStringView text, int position, int length) {
+    return text.mid(position, length);
+}
+
+inline std::string_view slice(std::string_view text, std::size_t position, std::size_t length) {
+    return text.substr(position, length);
+}
+
+template<typename View>
+bool startsSlideCommand(View text, std::size_t position) {
+    static auto const command = std::string_view("\\slide");
+    if(position + command.size() > std::size_t(text.size())) {
+        return false;
+    }
+    for(std::size_t i = 0; i < command.size(); i++) {
+        if(character(text, position + i) != command[i]) {
+            return false;
+        }
+    }
+    auto const end = position + command.size();
+    return end == std::size_t(text.size()) || !isWordCharacter(character(text, end));
+}
+
+// position after the last "\}", 0 if there is none
+template<typename View>
+std::size_t endOfLastClosingBracket(View text) {
+    for(auto i = std::size_t(text.size()); i >= 2; i--) {
+        if(character(text, i - 2) == '\\' && character(text, i - 1) == '}') {
+            return i;
+        }
+    }
+    return 0;
+}
+
+}
+
+// Splits the text in front of every "\slide" at the start of a line. The first chunk
+// contains the preamble and is empty if the text starts with "\slide". The text is
+// a QStringView or the UTF-8 bytes of the input in a std::string_view.
+template<typename View>
+std::vector<TextChunk<View>> splitAtSlides(View text) {
+    using namespace slidesplitter;
+    std::vector<TextChunk<View>> chunks;
+    auto const size = std::size_t(text.size());
+    auto const lastClosingBracket = endOfLastClosingBracket(text);
+    std::size_t chunkStart = 0;
+    int chunkLine = 0;
+    int line = 0;
+    bool inBracket = false;
+    for(std::size_t i = 0; i < size; i++) {
+        auto const current = character(text, i);
+        if(current == '\n') {
+            line++;
+            continue;
+        }
+        // text between \{ and \} is never split, like in the lexer \{ only opens a bracket if it gets closed
+        if(inBracket) {
+            if(current == '\\' && i + 1 < size && character(text, i + 1) == '}') {
+                inBracket = false;
+                i++;
+            }
+            continue;
+        }
+        if(current == '\\' && i + 1 < size && character(text, i + 1) == '{' && lastClosingBracket >= i + 4) {
+            inBracket = true;
+            i++;
+            continue;
+        }
+        bool const startOfLine = i == 0 || character(text, i - 1) == '\n';
+        if(startOfLine && startsSlideCommand(text, i)) {
+            chunks.push_back({slice(text, chunkStart, i - chunkStart), chunkLine});
+            chunkStart = i;
+            chunkLine = line;
+        }
+    }
+    chunks.push_back({slice(text, chunkStart, size - chunkStart), chunkLine});
+    return chunks;
+}
+
+#endif // SLIDESPLITTER_H
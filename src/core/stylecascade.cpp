@@ -0,0 +1,243 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "stylecascade.h"
+#include "template.h"
+#include "utils.h"
+
+namespace {
+
+void applyClassIDDefinclass(Box& box) {
+    if(box.properties().find(PropertyId::Class) != box.properties().end()) {
+        box.style().mClass = box.properties().find(PropertyId::Class)->second.mValue;
+    }
+    if(box.properties().find(PropertyId::Id) != box.properties().end()) {
+        box.style().mId = box.properties().find(PropertyId::Id)->second.mValue;
+    }
+    if(box.properties().find(PropertyId::Defineclass) != box.properties().end()) {
+        box.style().mDefineclass = box.properties().find(PropertyId::Defineclass)->second.mValue;
+    }
+}
+
+void applyGeometryToBoxIfSetInModel(Box& box, const BoxGeometry &modelGeometry) {
+
+    if(modelGeometry.left()) {
+        box.geometry().setLeft(modelGeometry.leftDisplay());
+    }
+    if(modelGeometry.top()) {
+        box.geometry().setTop(modelGeometry.topDisplay());
+    }
+    if(modelGeometry.width()) {
+        box.geometry().setWidth(modelGeometry.widthDisplay());
+    }
+    if(modelGeometry.height()) {
+        box.geometry().setHeight(modelGeometry.heightDisplay());
+    }
+    if(modelGeometry.angle()) {
+        box.geometry().setAngle(modelGeometry.angleDisplay());
+    }
+}
+
+void applyStandardTemplateToBox(Box& box) {
+    QRect rect;
+    auto style = box.style();
+
+    // set standard geometry
+    if(style.getClass() == "title") {
+        rect = QRect(50, 40, 1500, 100);
+    }
+    else if(style.getClass() == "body") {
+        rect = QRect(50, 150, 1500, 650);
+    }
+    else if(style.getClass() == "code") {
+        rect = QRect(50, 150, 1500, 650);
+        if(!style.mFont) {
+            style.mFont = "DejaVu Sans Mono";
+        }
+    }
+    else if(style.getClass() == "image") {
+        rect = QRect(50, 150, 1500, 650);
+    }
+    else if(style.getClass() == "right_column") {
+        rect = QRect(830, 150, 720, 650);
+    }
+    else if(style.getClass() == "left_column") {
+        rect = QRect(50, 150, 720, 650);
+    }
+    else if(style.getClass() == "fullscreen") {
+        rect = QRect(0, 0, 1600, 900);
+    }
+    else {
+        rect = QRect(50, 200, 300, 100);
+    }
+
+    applyGeometryToBoxIfSetInModel(box, BoxGeometry(rect, 0));
+}
+
+void setStyleToBoxIfSetInModel(Box& box, BoxStyle const& modelStyle) {
+    auto const assignIfSet = [](auto& value, auto const& standard) {
+        if(standard) {
+            value = standard;
+        }
+    };
+
+    assignIfSet(box.style().mFont, modelStyle.mFont);
+    assignIfSet(box.style().mFontSize, modelStyle.mFontSize);
+    assignIfSet(box.style().mFontWeight, modelStyle.mFontWeight);
+    assignIfSet(box.style().mColor, modelStyle.mColor);
+    assignIfSet(box.style().mBackgroundColor, modelStyle.mBackgroundColor);
+    assignIfSet(box.style().mAlignment, modelStyle.mAlignment);
+    assignIfSet(box.style().mLanguage, modelStyle.mLanguage);
+    assignIfSet(box.style().mHighlight, modelStyle.mHighlight);
+    assignIfSet(box.style().mLineSpacing, modelStyle.mLineSpacing);
+    assignIfSet(box.style().mOpacity, modelStyle.mOpacity);
+    assignIfSet(box.style().mPadding, modelStyle.mPadding);
+    assignIfSet(box.style().mBorderRadius, modelStyle.mBorderRadius);
+    assignIfSet(box.style().mTextMarker.color, modelStyle.mTextMarker.color);
+    assignIfSet(box.style().mTextMarker.fontWeight, modelStyle.mTextMarker.fontWeight);
+    assignIfSet(box.style().mBorder.width, modelStyle.mBorder.width);
+    assignIfSet(box.style().mBorder.style, modelStyle.mBorder.style);
+    assignIfSet(box.style().mBorder.color, modelStyle.mBorder.color);
+    if(modelStyle.mText && !modelStyle.mText->isEmpty()) {
+        box.style().mText = modelStyle.mText;
+    }
+}
+
+void setStyleToBoxIfNotSettedAndSetInModel(Box& box, BoxStyle const& modelStyle) {
+    auto const assignIfSet = [](auto& value, auto const& standard) {
+        if(standard && !value) {
+            value = standard;
+        }
+    };
+
+    assignIfSet(box.style().mFont, modelStyle.mFont);
+    assignIfSet(box.style().mFontSize, modelStyle.mFontSize);
+    assignIfSet(box.style().mFontWeight, modelStyle.mFontWeight);
+    assignIfSet(box.style().mColor, modelStyle.mColor);
+    assignIfSet(box.style().mBackgroundColor, modelStyle.mBackgroundColor);
+    assignIfSet(box.style().mAlignment, modelStyle.mAlignment);
+    assignIfSet(box.style().mLanguage, modelStyle.mLanguage);
+    assignIfSet(box.style().mHighlight, modelStyle.mHighlight);
+    assignIfSet(box.style().mLineSpacing, modelStyle.mLineSpacing);
+    assignIfSet(box.style().mOpacity, modelStyle.mOpacity);
+    assignIfSet(box.style().mPadding, modelStyle.mPadding);
+    assignIfSet(box.style().mBorderRadius, modelStyle.mBorderRadius);
+    assignIfSet(box.style().mTextMarker.color, modelStyle.mTextMarker.color);
+    assignIfSet(box.style().mTextMarker.fontWeight, modelStyle.mTextMarker.fontWeight);
+    assignIfSet(box.style().mBorder.width, modelStyle.mBorder.width);
+    assignIfSet(box.style().mBorder.style, modelStyle.mBorder.style);
+    assignIfSet(box.style().mBorder.color, modelStyle.mBorder.color);
+    if(modelStyle.mText && !modelStyle.mText->isEmpty()) {
+        box.style().mText = modelStyle.mText;
+    }
+}
+
+void applyDefinedClasses(QString const& slideKey, Box& box, StyleCascade::DefinedClasses const& definedClasses) {
+    if(!box.style().mClass){
+        return;
+    }
+    auto const boxKey = box.style().mClass.value();
+    if(definedClasses.find(boxKey) != definedClasses.end()) {
+        auto const& definedClassStyle = definedClasses.find(boxKey)->second;
+        applyGeometryToBoxIfSetInModel(box, definedClassStyle.mGeometry);
+        setStyleToBoxIfSetInModel(box, definedClassStyle);
+    }
+    if(definedClasses.find(slideKey + "-" + boxKey) != definedClasses.end()) {
+        auto const& definedClassStyle = definedClasses.find(slideKey + "-" + boxKey)->second;
+        applyGeometryToBoxIfSetInModel(box, definedClassStyle.mGeometry);
+        setStyleToBoxIfSetInModel(box, definedClassStyle);
+    }
+}
+
+void setTitleIfTextUnset(QString const& slideId, Box& box) {
+    if(box.style().mClass == "title" && box.style().text().isEmpty()) {
+        auto style = box.style();
+        style.mText = slideId;
+        box.setBoxStyle(style);
+    }
+}
+
+void applyJSONToBox(Box& box, ConfigBoxes const& config) {
+    auto const boxConfig = config.getRect(box.configId());
+    if(boxConfig.empty()) {
+        return;
+    }
+    box.geometry().setLeft(boxConfig.rect.left());
+    box.geometry().setTop(boxConfig.rect.top());
+    box.geometry().setWidth(boxConfig.rect.width());
+    box.geometry().setHeight(boxConfig.rect.height());
+    box.geometry().setAngle(boxConfig.angle);
+}
+
+bool contains(StyleCascade::Layer first, StyleCascade::Layer last, StyleCascade::Layer layer) {
+    return first <= layer && layer <= last;
+}
+
+}
+
+StyleCascade::StyleCascade(std::shared_ptr<Template> presentationTemplate, std::shared_ptr<DefinedClasses const> definedClasses,
+                           std::shared_ptr<ConfigBoxes const> configuration)
+    : mTemplate(std::move(presentationTemplate))
+    , mDefinedClasses(std::move(definedClasses))
+    , mConfiguration(std::move(configuration))
+{
+}
+
+void StyleCascade::apply(Slide& slide, Layer first, Layer last) const {
+    // the variables are the same for all boxes of the slide
+    std::shared_ptr<BoxStyle const> variablesStyle;
+    if(contains(first, last, Layer::Variables)) {
+        variablesStyle = variablesToBoxStyle(slide.variables());
+    }
+    for(auto const& box: slide.boxes()) {
+        resolve(slide, *box, first, last, variablesStyle.get());
+    }
+    // the boxes of the template are already styled, they only need the variables of the slide
+    if(mTemplate && variablesStyle) {
+        slide.setTemplateBoxes(mTemplate->templateBoxes(slide.slideClass(), variablesStyle));
+    }
+}
+
+void StyleCascade::applyToBox(Slide const& slide, Box& box, Layer first, Layer last) const {
+    std::shared_ptr<BoxStyle const> variablesStyle;
+    if(contains(first, last, Layer::Variables)) {
+        variablesStyle = variablesToBoxStyle(slide.variables());
+    }
+    resolve(slide, box, first, last, variablesStyle.get());
+}
+
+void StyleCascade::applyVariables(Box& box, BoxStyle const& variablesStyle) {
+    setStyleToBoxIfNotSettedAndSetInModel(box, variablesStyle);
+}
+
+void StyleCascade::resolve(Slide const& slide, Box& box, Layer first, Layer last, BoxStyle const* variablesStyle) const {
+    if(contains(first, last, Layer::StandardClasses)) {
+        applyClassIDDefinclass(box);
+        applyStandardTemplateToBox(box);
+    }
+    if(mTemplate && contains(first, last, Layer::Template)) {
+        applyDefinedClasses(slide.slideClass(), box, *mTemplate->definedClasses());
+    }
+    if(contains(first, last, Layer::DefinedClasses)) {
+        if(mDefinedClasses) {
+            applyDefinedClasses(slide.slideClass(), box, *mDefinedClasses);
+        }
+        setTitleIfTextUnset(slide.id(), box);
+    }
+    if(mConfiguration && contains(first, last, Layer::Configuration)) {
+        applyJSONToBox(box, *mConfiguration);
+    }
+    if(contains(first, last, Layer::Properties)) {
+        setStyleToBoxIfSetInModel(box, *propertyMapToBoxStyle(box.properties()));
+        // the text is not part of the shared style of the properties
+        if(auto const text = box.properties().find(PropertyId::Text); text != box.properties().end() && !text->second.mValue.isEmpty()) {
+            box.style().mText = text->second.mValue;
+        }
+    }
+    if(variablesStyle && contains(first, last, Layer::Variables)) {
+        setStyleToBoxIfNotSettedAndSetInModel(box, *variablesStyle);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef STYLECASCADE_H
+#define STYLECASCADE_H
+
+#include "slide.h"
+#include "configboxes.h"
+
+#include <map>
+
+class Template;
+
+// Resolves the styles of the boxes of a slide. Every box is visited once and the sources
+// of its style are applied in the order of the layers, a later layer replaces the values
+// set by the earlier ones.
+class StyleCascade
+{
+public:
+    enum class Layer {
+        // class, id and defined class given as properties, and the geometry of the standard classes
+        StandardClasses,
+        // classes defined by the template
+        Template,
+        // classes defined in the presentation, the slide id is the default title
+        DefinedClasses,
+        // geometry saved in the configuration file
+        Configuration,
+        // properties given in square brackets
+        Properties,
+        // properties set as variables, e.g. by \setvar color black, for values that are still unset,
+        // the slide gets the boxes of the template styled with its variables
+        Variables
+    };
+    using DefinedClasses = std::map<QString, BoxStyle>;
+
+    StyleCascade(std::shared_ptr<Template> presentationTemplate, std::shared_ptr<DefinedClasses const> definedClasses,
+                 std::shared_ptr<ConfigBoxes const> configuration);
+
+    // applies the layers from first to last to the boxes of the slide
+    void apply(Slide& slide, Layer first = Layer::StandardClasses, Layer last = Layer::Variables) const;
+    // applies the layers to one box of the slide, the slide itself is not changed
+    void applyToBox(Slide const& slide, Box& box, Layer first, Layer last) const;
+    // the Variables layer for a box, e.g. a box of the template
+    static void applyVariables(Box& box, BoxStyle const& variablesStyle);
+
+private:
+    // variablesStyle is only set if the variables are in the layers
+    void resolve(Slide const& slide, Box& box, Layer first, Layer last, BoxStyle const* variablesStyle) const;
+
+private:
+    std::shared_ptr<Template> mTemplate;
+    std::shared_ptr<DefinedClasses const> mDefinedClasses;
+    std::shared_ptr<ConfigBoxes const> mConfiguration;
+};
+
+#endif // STYLECASCADE_H
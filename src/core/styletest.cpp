@@ -0,0 +1,176 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "styletest.h"
+
+#include "texttemplate.h"
+#include "parser.h"
+#include "presentationdata.h"
+#include "template.h"
+#include "utils.h"
+
+QTEST_MAIN(StyleTest)
+
+namespace {
+
+// one line for each box and template box with the resolved style
+QStringList dumpStyles(SlideList const& slides) {
+    QStringList lines;
+    for(auto const& slide: slides.vector) {
+        auto boxes = slide->boxes();
+        auto const templateBoxes = slide->templateBoxes();
+        boxes.insert(boxes.end(), templateBoxes.begin(), templateBoxes.end());
+        for(auto const& box: boxes) {
+            auto const& style = box->style();
+            auto const rect = style.geometry().rect();
+            lines << QString("%1 %2 %3").arg(slide->id(), box->id(), style.getClass())
+                     + QString(" geometry %1 %2 %3 %4 %5").arg(rect.left()).arg(rect.top()).arg(rect.width()).arg(rect.height())
+                       .arg(style.geometry().angleDisplay())
+                     + QString(" font %1 %2 line %3 color %4").arg(style.font()).arg(style.fontSize()).arg(style.linespacing())
+                       .arg(style.color().name(QColor::HexArgb));
+        }
+    }
+    return lines;
+}
+
+}
+
+void StyleTest::testTextTemplate() {
+    QFETCH(QString, text);
+    QFETCH(QString, substituted);
+    Variables variables;
+    variables.set("%{pagenumber}", "3");
+    variables.set("%{title}", "Potato");
+    QCOMPARE(TextTemplate(text).substitute(variables), substituted);
+}
+
+void StyleTest::testTextTemplate_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("substituted");
+    QTest::newRow("no variable") << "Hello" << "Hello";
+    QTest::newRow("only variable") << "%{pagenumber}" << "3";
+    QTest::newRow("variables") << "%{title}: page %{pagenumber}." << "Potato: page 3.";
+    QTest::newRow("unknown variable") << "%{date} %{pagenumber}" << "%{date} 3";
+    QTest::newRow("not closed") << "page %{pagenumber" << "page %{pagenumber";
+    QTest::newRow("percent") << "100% %{pagenumber}" << "100% 3";
+}
+
+void StyleTest::testStyleCascade() {
+    auto const templateOutput = generateSlides(QString("\\setvar font-family Linux Biolinum\n"
+                                                       "\\slide[defineclass: default] default\n"
+                                                       "\\text[defineclass: title; font-size: 45; color: white]\n"
+                                                       "\\text[defineclass: body; left: 70]\n"
+                                                       "\\text[class: pagenumber] %{pagenumber}\n"), {}, true);
+    QVERIFY(templateOutput.successfull());
+    auto const presentationTemplate = std::make_shared<Template>();
+    presentationTemplate->setData(templateOutput.slideList());
+
+    auto const text = QString("\\setvar color #333\n"
+                              "\\slide[defineclass: special] classes\n"
+                              "\\text[defineclass: note; font-size: 20; left: 100]\n"
+                              "\\slide one\n\\title\n\\body[line-height: 2] text\n\\text[class: note] note\n"
+                              "\\slide[class: special] two\n\\title Two\n\\text[class: note; color: red] %{pagenumber}\n"
+                              "\\text[id: moved] moved\n");
+    ConfigBoxes config;
+    config.addRect(BoxGeometry(QRect(10, 20, 300, 40), 15).toValue(), "moved");
+
+    PresentationData data(generateSlides(text, {}).slideList(), presentationTemplate);
+    data.applyConfiguration(config);
+
+    // the geometry given as property is not applied by the styling
+    auto const expected = QStringList{
+        "classes intern-classes-text-default-0 default geometry 50 200 300 100 0 font Linux Biolinum 20 line 1.15 color #ff333333",
+        "classes intern-default-text-pagenumber-0 pagenumber geometry 50 200 300 100 0 font Linux Biolinum 26 line 1.15 color #ff333333",
+        "one intern-one-title-title-0 title geometry 50 200 300 100 0 font Linux Biolinum 45 line 1.15 color #ffffffff",
+        "one intern-one-body-body-0 body geometry 50 200 300 100 0 font Linux Biolinum 26 line 2 color #ff333333",
+        "one intern-one-text-note-0 note geometry 50 200 300 100 0 font Linux Biolinum 26 line 1.15 color #ff333333",
+        "one intern-default-text-pagenumber-0 pagenumber geometry 50 200 300 100 0 font Linux Biolinum 26 line 1.15 color #ff333333",
+        "two intern-two-title-title-0 title geometry 50 40 1500 100 0 font Linux Biolinum 26 line 1.15 color #ff333333",
+        "two intern-two-text-note-0 note geometry 50 200 300 100 0 font Linux Biolinum 20 line 1.15 color #ffff0000",
+        "two moved default geometry 10 20 300 40 15 font Linux Biolinum 26 line 1.15 color #ff333333"
+    };
+    QCOMPARE(dumpStyles(data.slides()), expected);
+
+    auto const one = data.slides().findSlide("one");
+    QCOMPARE(one->boxes()[0]->style().text(), QString("one"));
+    QCOMPARE(one->templateBoxes().size(), std::size_t(1));
+    // the slides of a class with the same variables share the boxes of the template
+    QCOMPARE(data.slides().findSlide("classes")->templateBoxes()[0], one->templateBoxes()[0]);
+    auto const two = data.slides().findSlide("two");
+    QCOMPARE(two->findBox("moved")->style().geometry().rect(), QRect(10, 20, 300, 40));
+}
+
+void StyleTest::testStyleMemo() {
+    Box::Properties const first{{PropertyId::Class, {"body", 1}}, {PropertyId::Color, {"grey", 1}}, {PropertyId::Text, {"a", 1}}};
+    auto second = first;
+    second[PropertyId::Text] = {"b", 5};
+    auto const before = styleMemoStatistics();
+    auto const style = propertyMapToBoxStyle(first);
+    // the text is not part of the style
+    QVERIFY(propertyMapToBoxStyle(second) == style);
+    QVERIFY(!style->mText);
+    QCOMPARE(style->color(), QColor("grey"));
+    auto const after = styleMemoStatistics();
+    QCOMPARE(after.misses, before.misses + 1);
+    QCOMPARE(after.hits, before.hits + 1);
+
+    // an invalid value is reported for every box
+    Box::Properties const invalid{{PropertyId::FontSize, {"big", 3}}};
+    QVERIFY_EXCEPTION_THROWN(propertyMapToBoxStyle(invalid), PorpertyConversionError);
+    QVERIFY_EXCEPTION_THROWN(propertyMapToBoxStyle(invalid), PorpertyConversionError);
+
+    // only the variables that are properties are compared
+    Variables firstSlide;
+    firstSlide.set("%{color}", "#123456");
+    firstSlide.set("%{pagenumber}", "1");
+    auto secondSlide = firstSlide;
+    secondSlide.set("%{pagenumber}", "2");
+    QVERIFY(variablesToBoxStyle(firstSlide) == variablesToBoxStyle(secondSlide));
+    QCOMPARE(variablesToBoxStyle(firstSlide)->color(), QColor("#123456"));
+
+    // a built slide is not styled again when it is painted again
+    PresentationData data(generateSlides(QString("\\setvar color red\n\\slide one\n\\title[color: blue] Title\n\\body text\n"), {}).slideList());
+    data.applyConfiguration(ConfigBoxes());
+    auto const& slide = data.slides().slideAt(0);
+    slide->boxes();
+    auto const built = styleMemoStatistics();
+    slide->boxes();
+    slide->templateBoxes();
+    QCOMPARE(styleMemoStatistics().hits + styleMemoStatistics().misses, built.hits + built.misses);
+    QCOMPARE(slide->boxes()[1]->style().color(), QColor("red"));
+}
+
+void StyleTest::testRestyleBox() {
+    auto const text = QString("\\slide classes\n\\text[defineclass: note; id: definition; font-size: 20]\n"
+                              "\\slide one\n\\text[class: note] a\n\\text[id: plain] b\n"
+                              "\\slide two\n\\text[class: note] c\n");
+    ConfigBoxes config;
+    config.addRect(BoxGeometry(QRect(200, 20, 300, 40), 0).toValue(), "definition");
+    config.addRect(BoxGeometry(QRect(10, 20, 300, 40), 30).toValue(), "plain");
+
+    PresentationData data(generateSlides(text, {}).slideList());
+    data.applyConfiguration(config);
+    auto const one = data.slides().findSlide("one");
+    QCOMPARE(one->boxes()[0]->style().geometry().rect().left(), 200);
+    QVERIFY(!data.slides().findSlide("two")->built());
+
+    // only the built slides with boxes of the class are changed
+    config.deleteRect("definition");
+    QCOMPARE(data.restyleBox("definition", config), std::vector<int>({0, 1}));
+    QCOMPARE(one->boxes()[0]->style().geometry().rect().left(), 50);
+    QCOMPARE(one->boxes()[0]->style().fontSize(), 20);
+    QCOMPARE(one->findBox("plain")->style().geometry().angleDisplay(), 30.);
+
+    config.deleteAngle("plain");
+    QCOMPARE(data.restyleBox("plain", config), std::vector<int>({1}));
+    QCOMPARE(one->findBox("plain")->style().geometry().rect(), QRect(10, 20, 300, 40));
+    QCOMPARE(one->findBox("plain")->style().geometry().angleDisplay(), 0.);
+
+    // the same as styling all slides with the configuration
+    PresentationData reference(generateSlides(text, {}).slideList());
+    reference.applyConfiguration(config);
+    QCOMPARE(dumpStyles(data.slides()), dumpStyles(reference.slides()));
+}
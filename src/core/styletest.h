@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef STYLETEST_H
+#define STYLETEST_H
+
+#include <QtTest/QTest>
+
+class StyleTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTextTemplate();
+    void testTextTemplate_data();
+    void testStyleCascade();
+    void testStyleMemo();
+    void testRestyleBox();
+};
+
+#endif // STYLETEST_H
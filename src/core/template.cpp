@@ -6,17 +6,16 @@
 
 #include "template.h"
 #include "utils.h"
+#include "parser.h"
 #include <QFile>
+#include <QFileInfo>
 #include <algorithm>
 
-namespace  {
-void addVariableIfNotExist(Variables & variables, Variables const& addedVariables) {
-    for(auto const& addedVariable: addedVariables) {
-        if(variables.find(addedVariable.first) == variables.end()) {
-            variables[addedVariable.first] = addedVariable.second;
-        }
-    }
-}
+namespace {
+
+// the boxes of a template are created again when there are more entries, e.g. after the style memo was cleared
+constexpr std::size_t maxTemplateBoxes = 1000;
+
 }
 
 Template::Template(const SlideList &slides)
@@ -26,7 +25,9 @@ Template::Template(const SlideList &slides)
 
 void Template::setConfig(ConfigBoxes config) {
     mData.applyConfiguration(config);
-    mConfig = config;
+    mConfig = std::move(config);
+    QMutexLocker locker(&mTemplateBoxesMutex);
+    mTemplateBoxes.clear();
 }
 
 Box::List Template::getTemplateSlide(QString slideId) const {
@@ -40,24 +41,45 @@ Box::List Template::getTemplateSlide(QString slideId) const {
     return boxes;
 }
 
-void Template::applyTemplate(SlideList& slideList) {
-    mData.applyDefinedClass(slideList, mConfig);
-    for(auto const& slide: slideList.vector) {
-        auto const slideclass = slide->slideClass();
-        auto const boxlist = getTemplateSlide(slideclass);
-        slide->setTemplateBoxes(copy(boxlist));
-        addVariableIfNotExist(slide->variables(), variables());
+Box::List Template::templateBoxes(QString const& slideClass, std::shared_ptr<BoxStyle const> const& variablesStyle) const {
+    QMutexLocker locker(&mTemplateBoxesMutex);
+    auto const key = std::make_pair(slideClass, variablesStyle);
+    if(auto const boxes = mTemplateBoxes.find(key); boxes != mTemplateBoxes.end()) {
+        return boxes->second;
+    }
+    if(mTemplateBoxes.size() >= maxTemplateBoxes) {
+        mTemplateBoxes.clear();
     }
+    auto boxes = copy(getTemplateSlide(slideClass));
+    if(variablesStyle) {
+        for(auto const& box: boxes) {
+            StyleCascade::applyVariables(*box, *variablesStyle);
+        }
+    }
+    mTemplateBoxes[key] = boxes;
+    return boxes;
+}
+
+std::shared_ptr<PresentationData::DefinedClasses const> const& Template::definedClasses() const {
+    return mData.definedClasses();
+}
+
+void Template::applyVariables(Slide& slide) const {
+    slide.variables().setFallback(variables());
 }
 
 
-Variables const& Template::variables() {
+Variables const& Template::variables() const {
     return mData.slides().lastSlide()->variables();
 }
 
 void Template::setData(PresentationData data) {
-    mData = data;
+    mData = std::move(data);
     mData.applyConfiguration(mConfig);
+    {
+        QMutexLocker locker(&mTemplateBoxesMutex);
+        mTemplateBoxes.clear();
+    }
     for(auto const& slide: mData.slides().vector) {
         auto path = slide->removeVariable("{resourcepath}");
         if(!path) {
@@ -65,4 +87,40 @@ void Template::setData(PresentationData data) {
         }
         slide->setVariable("%{templateresourcepath}", path.value());
     }
+    if(!mData.slides().empty()) {
+        mData.slides().lastSlide()->variables().share();
+    }
+    // the template is used by the builds in the background and by the slides that are
+    // styled later, it is small and built at once so that it is not changed afterwards
+    for(auto const& slide: mData.slides().vector) {
+        slide->boxes();
+    }
+}
+
+Template::Ptr loadTemplate(QString const& templateName) {
+    if(templateName.isEmpty()) {
+        return {};
+    }
+    auto const fileName = templateName + ".potato";
+    if(!QFile::exists(fileName)){
+        throw TemplateError{QObject::tr("Cannot load template %1.").arg(fileName)};
+    }
+    auto thisTemplate = std::make_shared<Template>();
+    try {
+        thisTemplate->setConfig(templateName + ".json");
+    }  catch (ConfigError error) {
+        throw TemplateError{QObject::tr("Cannot load template %1.").arg(error.filename)};
+    }
+    auto const directoryPath = QFileInfo(templateName).absolutePath();
+    auto parserOutput = generateSlidesFromFile(fileName, directoryPath, true);
+
+    if(!parserOutput.successfull()) {
+        throw TemplateError{"Cannot load template \u26A0"};
+    }
+    try {
+        thisTemplate->setData(parserOutput.takeSlideList());
+    }  catch (PorpertyConversionError & error) {
+        throw TemplateError{"Cannot load template: Line " + QString::number(error.line + 1) + ": " + error.message + " \u26A0"};
+    }
+    return thisTemplate;
 }
@@ -7,6 +7,7 @@
 # pragma once
 
 #include <QPainter>
+#include <QMutex>
 #include "slide.h"
 #include "configboxes.h"
 #include "presentationdata.h"
@@ -26,10 +27,17 @@ public:
     void setConfig(ConfigBoxes config);
     void setData(PresentationData data);
 
-    // apply template to a slide list
-    void applyTemplate(SlideList& slideList);
+    // boxes of the template for the slide class styled with the variables of a slide. They are
+    // created once and shared by the slides of the class with the same variables, so they must
+    // not be changed. The parts that differ per slide, e.g. %{pagenumber}, are substituted when
+    // the boxes are painted.
+    Box::List templateBoxes(QString const& slideClass, std::shared_ptr<BoxStyle const> const& variablesStyle) const;
+    // classes defined by the template, they are applied to the boxes by the StyleCascade
+    std::shared_ptr<PresentationData::DefinedClasses const> const& definedClasses() const;
+    // the slide shares the variables of the template
+    void applyVariables(Slide& slide) const;
 
-    Variables const& variables();
+    Variables const& variables() const;
 
 private:
     Box::List getTemplateSlide(QString slideId) const;
@@ -38,4 +46,11 @@ private:
     PresentationData mData;
     std::map<QString, Slide> mTemplateSlides;
     ConfigBoxes mConfig;
+    // the template is used by the builds in the background and by the slides styled later
+    mutable QMutex mTemplateBoxesMutex;
+    // the style memo gives equal variables the same style, so the style is compared by its address
+    mutable std::map<std::pair<QString, std::shared_ptr<BoxStyle const>>, Box::List> mTemplateBoxes;
 };
+
+// Reads templateName.potato and templateName.json, throws a TemplateError if this fails.
+Template::Ptr loadTemplate(QString const& templateName);
@@ -23,6 +23,10 @@ Template::Ptr TemplateCache::getTemplate(QString path) const {
     return {};
 }
 
+QString const& TemplateCache::path() const {
+    return mPath;
+}
+
 void TemplateCache::setTemplate(Template::Ptr newTemplate, QString path) {
     mPath = path;
     mTemplate = newTemplate;
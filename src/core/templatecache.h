@@ -18,6 +18,7 @@ public:
     TemplateCache();
 
     Template::Ptr getTemplate(QString path) const;
+    QString const& path() const;
     void setTemplate(Template::Ptr newTemplate, QString path);
     void resetTemplate();
 
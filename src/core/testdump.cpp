@@ -0,0 +1,38 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "testdump.h"
+
+#include <typeinfo>
+
+QStringList dump(ParserOutput const& output) {
+    QStringList lines;
+    if(!output.successfull()) {
+        auto const error = output.parserError();
+        lines << "error line " + QString::number(error.line) + " " + error.message;
+        return lines;
+    }
+    lines << "preamble " + output.preamble().templateName + " " + QString::number(output.preamble().line);
+    for(auto const& slide: output.slideList().vector) {
+        lines << "slide " + slide->id() + " line " + QString::number(slide->line()) + " page " + QString::number(slide->pagenumber())
+                 + " class " + slide->slideClass() + " defines " + slide->definesClass();
+        for(auto const& [name, value]: slide->variables().toMap()) {
+            lines << "  variable " + name + " = " + value;
+        }
+        for(auto const& box: slide->boxes()) {
+            lines << QString("  box %1 %2 config %3 line %4 pause %5 %6").arg(typeid(*box).name(), box->id(), box->configId())
+                     .arg(box->line()).arg(box->pauseCounter().mCount).arg(box->pauseCounter().mDisplayMode);
+            lines << "    text " + box->style().text();
+            auto properties = QStringList();
+            for(auto const& [name, entry]: box->properties()) {
+                properties << "    property " + propertyName(name) + " = " + entry.mValue + " line " + QString::number(entry.mLine);
+            }
+            properties.sort();
+            lines << properties;
+        }
+    }
+    return lines;
+}
@@ -0,0 +1,17 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef TESTDUMP_H
+#define TESTDUMP_H
+
+#include "parser.h"
+
+#include <QStringList>
+
+// everything the parser sets, to compare the output of two parsers in the tests
+QStringList dump(ParserOutput const& output);
+
+#endif // TESTDUMP_H
@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "texttemplate.h"
+
+TextTemplate::TextTemplate(QString const& text)
+    : mText(text)
+{
+    // a variable starts with "%{" and ends at the next "}"
+    int position = 0;
+    while(true) {
+        auto const begin = mText.indexOf(QLatin1String("%{"), position);
+        if(begin < 0) {
+            break;
+        }
+        auto const end = mText.indexOf(QLatin1Char('}'), begin + 2);
+        if(end < 0) {
+            break;
+        }
+        if(begin > position) {
+            mSegments.push_back({position, begin - position, {}});
+        }
+        mSegments.push_back({begin, end + 1 - begin, mText.mid(begin, end + 1 - begin)});
+        position = end + 1;
+    }
+    if(!mSegments.empty() && position < mText.size()) {
+        mSegments.push_back({position, int(mText.size()) - position, {}});
+    }
+}
+
+QString const& TextTemplate::text() const {
+    return mText;
+}
+
+bool TextTemplate::hasVariables() const {
+    return !mSegments.empty();
+}
+
+QString TextTemplate::substitute(Variables const& variables) const {
+    if(!hasVariables()) {
+        return mText;
+    }
+    QString result;
+    result.reserve(mText.size());
+    for(auto const& segment: mSegments) {
+        if(!segment.variable.isEmpty()) {
+            if(auto const value = variables.value(segment.variable)) {
+                result.append(value.value());
+                continue;
+            }
+        }
+        result.append(mText.constData() + segment.start, segment.length);
+    }
+    return result;
+}
@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef TEXTTEMPLATE_H
+#define TEXTTEMPLATE_H
+
+#include "variables.h"
+
+#include <QString>
+#include <vector>
+
+// Text split at the variables, e.g. "Page %{pagenumber}" into the literal "Page " and
+// the variable %{pagenumber}. It is split once, the variables are filled in on every draw.
+class TextTemplate
+{
+public:
+    explicit TextTemplate(QString const& text);
+
+    QString const& text() const;
+    bool hasVariables() const;
+
+    // variables that are not set are kept as they are written
+    QString substitute(Variables const& variables) const;
+
+private:
+    // a literal part of the text or a variable with its name, e.g. "%{pagenumber}"
+    struct Segment {
+        int start;
+        int length;
+        QString variable;
+    };
+
+    QString mText;
+    std::vector<Segment> mSegments;
+};
+
+#endif // TEXTTEMPLATE_H
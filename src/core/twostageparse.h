@@ -0,0 +1,37 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef TWOSTAGEPARSE_H
+#define TWOSTAGEPARSE_H
+
+#include "antlr4-runtime.h"
+
+// Runs the start rule of an ANTLR parser, e.g. parseTwoStage(parser, &potatoParser::potato).
+// The input is first parsed with SLL prediction, which is fast but can fail on valid
+// input. It stops at the first error without reporting it, only then the input is
+// parsed again with full LL prediction and the error listeners of the parser.
+template<typename Parser, typename Context>
+Context* parseTwoStage(Parser& parser, Context* (Parser::*rule)()) {
+    auto const interpreter = parser.template getInterpreter<antlr4::atn::ParserATNSimulator>();
+    auto const listeners = parser.getErrorListeners();
+    parser.removeErrorListeners();
+    parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    try {
+        return (parser.*rule)();
+    }  catch (antlr4::ParseCancellationException const&) {
+    }
+
+    parser.reset();
+    for(auto const listener: listeners) {
+        parser.addErrorListener(listener);
+    }
+    parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+    return (parser.*rule)();
+}
+
+#endif // TWOSTAGEPARSE_H
@@ -5,71 +5,157 @@
 */
 
 #include "src/core/utils.h"
+#include <QHash>
+#include <QMutex>
 #include <set>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
 
-BoxStyle propertyMapToBoxStyle(const Box::Properties &properties) {
-    BoxStyle boxStyle;
-    for (auto const& entry: properties) {
-        applyProperty(entry.first, entry.second, boxStyle);
-    }
-    return boxStyle;
-}
+namespace {
 
-BoxStyle variablesToBoxStyle(Variables const& variables) {
-    BoxStyle boxStyle;
-    for (auto const& var: variables) {
-        auto property = var.first;
-        property.remove(0, 2);
-        property.chop(1);
-        try {
-            applyProperty(property, var.second, 0, boxStyle);
-        }  catch (PorpertyConversionError) {
-
-        }
+int toInt(QString const& value, int line) {
+    bool numberOk = true;
+    auto const number = value.toInt(&numberOk);
+    if(!numberOk) {
+        throw PorpertyConversionError {"Invalid number", line};
     }
-    return boxStyle;
+    return number;
 }
 
-void applyProperty(QString const& property, const QString &value, int line, BoxStyle & boxstyle) {
+double toDouble(QString const& value, int line) {
     bool numberOk = true;
+    auto const number = value.toDouble(&numberOk);
+    if(!numberOk) {
+        throw PorpertyConversionError {"Invalid number", line};
+    }
+    return number;
+}
 
-    if(property == "defineclass") {
-        boxstyle.mDefineclass = value;
+QColor toColor(QString const& value, int line, QString const& message) {
+    QColor color;
+    color.setNamedColor(value);
+    if(!color.isValid()) {
+        throw PorpertyConversionError {message, line};
     }
-    else if(property == "text") {
-        boxstyle.mText = value;
+    return color;
+}
+
+void applyBorder(QString const& value, int line, BoxStyle & boxstyle) {
+    static auto const borderStyles = std::set<QString>{"solid", "dashed", "dotted", "double"};
+    bool borderOk = true;
+    auto values = QString(value).split(" ");
+    if(values.empty()) {
+        throw PorpertyConversionError {
+            "Give border in format: \"border: border-width px border-style (required) border color\", e.g. \"4px solid red\"",
+            line
+        };
     }
-    else if(property == "class")  {
-        boxstyle.mClass = value;
+    if (values[0].endsWith("px") && values.length() >= 2) {
+        auto value = values[0];
+        value.chop(2);
+        boxstyle.mBorder.width = value.toInt(&borderOk);
+        if(borderStyles.find(values[1]) != borderStyles.end()) {
+            boxstyle.mBorder.style = values[1];
+        }
+        else {
+            borderOk = false;
+        }
+        if (values.length() >= 3) {
+            auto const color = QColor(QString(values[2]));
+            borderOk = borderOk && color.isValid();
+            boxstyle.mBorder.color = color;
+        }
     }
-    else if(property == "color") {
-        QColor color;
-        color.setNamedColor(QString(value));
-        if(!color.isValid()) {
-            throw PorpertyConversionError {
-                QString("Invalid color '%1'").arg(QString(value)),
-                line
-            };
+    else {
+        if(borderStyles.find(values[0]) != borderStyles.end()) {
+            boxstyle.mBorder.style = values[0];
+        }
+        else {
+            borderOk = false;
+        }
+        if(values.length() >= 2) {
+            auto const color = QColor(QString(values[1]));
+            borderOk = borderOk && color.isValid();
+            boxstyle.mBorder.color = color;
         }
-        boxstyle.mColor = color;
     }
-    else if(property == "opacity") {
-        boxstyle.mOpacity = value.toDouble(&numberOk);
+    if(!borderOk) {
+        throw PorpertyConversionError {
+            "Give border in format: \"border: border-width px border-style (required) border color\", e.g. \"4px solid red\"",
+            line
+        };
     }
-    else if(property == "font-size") {
-        boxstyle.mFontSize = value.toInt(&numberOk);
+}
+
+void applyMarker(QString const& value, int line, BoxStyle & boxstyle) {
+    auto values = QString(value).split(" ");
+    if(values.empty()) {
+        throw PorpertyConversionError{
+            "Give marker in the format: \"marker: color (required) font-weight (optional)\", e.g. blue bold, red",
+            line
+        };
     }
-    else if(property == "line-height") {
-        if(value.toDouble() != 0) {
-            boxstyle.mLineSpacing = value.toDouble(&numberOk);
+    if(values[0] == "bold") {
+        boxstyle.mTextMarker.fontWeight = FontWeight::bold;
+    }
+    else if(values[0] == "normal") {
+        boxstyle.mTextMarker.fontWeight = FontWeight::normal;
+    }
+    else {
+        boxstyle.mTextMarker.color = QColor(QString(values[0]));
+        if(values.length() > 1) {
+            if(values[1] == "bold") {
+                boxstyle.mTextMarker.fontWeight = FontWeight::bold;
+            }
+            else if(values[1] == "normal") {
+                boxstyle.mTextMarker.fontWeight = FontWeight::normal;
+            }
         }
     }
-    else if(property == "font-weight") {
-        if(QString(value) == "bold") {
+}
+
+using PropertyParser = void (*)(QString const& value, int line, BoxStyle & boxstyle);
+
+// converts the value and sets it in the boxstyle, the parsers are assigned by their PropertyId
+constexpr std::array<PropertyParser, int(PropertyId::Count)> propertyParsers = []{
+    std::array<PropertyParser, int(PropertyId::Count)> table{};
+    table[int(PropertyId::Angle)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mGeometry.setAngle(toDouble(value, line));
+        boxstyle.movable = false;
+    };
+    table[int(PropertyId::Background)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mBackgroundColor = toColor(value, line, "Invalid color");
+    };
+    table[int(PropertyId::BackgroundColor)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mBackgroundColor = toColor(value, line, "Invalid color");
+    };
+    table[int(PropertyId::Border)] = applyBorder;
+    table[int(PropertyId::BorderRadius)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mBorderRadius = toInt(value, line);
+    };
+    table[int(PropertyId::Class)] = [](QString const& value, int, BoxStyle & boxstyle) {
+        boxstyle.mClass = value;
+    };
+    table[int(PropertyId::Color)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mColor = toColor(value, line, QString("Invalid color '%1'").arg(value));
+    };
+    table[int(PropertyId::Defineclass)] = [](QString const& value, int, BoxStyle & boxstyle) {
+        boxstyle.mDefineclass = value;
+    };
+    table[int(PropertyId::FontFamily)] = [](QString const& value, int, BoxStyle & boxstyle) {
+        boxstyle.mFont = value;
+    };
+    table[int(PropertyId::FontSize)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mFontSize = toInt(value, line);
+    };
+    table[int(PropertyId::FontWeight)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        if(value == "bold") {
             boxstyle.mFontWeight = FontWeight::bold;
         }
-        else if(QString(value) == "normal") {
+        else if(value == "normal") {
             boxstyle.mFontWeight = FontWeight::normal;
         }
         else {
@@ -78,11 +164,26 @@ void applyProperty(QString const& property, const QString &value, int line, BoxS
                 line
             };
         }
-    }
-    else if(property == "font-family") {
-        boxstyle.mFont = QString(value);
-    }
-    else if(property == "id") {
+    };
+    table[int(PropertyId::Height)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mGeometry.setHeight(toInt(value, line));
+        boxstyle.movable = false;
+    };
+    table[int(PropertyId::Highlight)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        if(value == "false") {
+            boxstyle.mHighlight = false;
+        }
+        else if(value == "true") {
+            boxstyle.mHighlight = true;
+        }
+        else {
+            throw PorpertyConversionError {
+                "Invalid value for 'highlight' (possible values: true, false)",
+                line
+            };
+        }
+    };
+    table[int(PropertyId::Id)] = [](QString const& value, int line, BoxStyle & boxstyle) {
         boxstyle.mId = value;
         if(value.startsWith("intern")) {
             throw PorpertyConversionError {
@@ -90,28 +191,21 @@ void applyProperty(QString const& property, const QString &value, int line, BoxS
                 line
             };
         }
-    }
-    else if(property == "left") {
-        boxstyle.mGeometry.setLeft(value.toInt(&numberOk));
+    };
+    table[int(PropertyId::Language)] = [](QString const& value, int, BoxStyle & boxstyle) {
+        boxstyle.mLanguage = value;
+    };
+    table[int(PropertyId::Left)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mGeometry.setLeft(toInt(value, line));
         boxstyle.movable = false;
-    }
-    else if(property == "top") {
-        boxstyle.mGeometry.setTop(value.toInt(&numberOk));
-        boxstyle.movable = false;
-    }
-    else if(property == "width") {
-        boxstyle.mGeometry.setWidth(value.toInt(&numberOk));
-        boxstyle.movable = false;
-    }
-    else if(property == "height") {
-        boxstyle.mGeometry.setHeight(value.toInt(&numberOk));
-        boxstyle.movable = false;
-    }
-    else if(property == "angle") {
-        boxstyle.mGeometry.setAngle(value.toDouble(&numberOk));
-        boxstyle.movable = false;
-    }
-    else if(property == "movable") {
+    };
+    table[int(PropertyId::LineHeight)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        if(value.toDouble() != 0) {
+            boxstyle.mLineSpacing = toDouble(value, line);
+        }
+    };
+    table[int(PropertyId::Marker)] = applyMarker;
+    table[int(PropertyId::Movable)] = [](QString const& value, int line, BoxStyle & boxstyle) {
         if(value == "true") {
             boxstyle.movable = true;
         }
@@ -124,8 +218,17 @@ void applyProperty(QString const& property, const QString &value, int line, BoxS
                 line
             };
         }
-    }
-    else if(property == "text-align") {
+    };
+    table[int(PropertyId::Opacity)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mOpacity = toDouble(value, line);
+    };
+    table[int(PropertyId::Padding)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mPadding = toInt(value, line);
+    };
+    table[int(PropertyId::Text)] = [](QString const& value, int, BoxStyle & boxstyle) {
+        boxstyle.mText = value;
+    };
+    table[int(PropertyId::TextAlign)] = [](QString const& value, int line, BoxStyle & boxstyle) {
         if(value == "left") {
             boxstyle.mAlignment = Qt::AlignLeft;
         }
@@ -144,133 +247,126 @@ void applyProperty(QString const& property, const QString &value, int line, BoxS
                 line
             };
         }
-    }
-    else if(property == "language") {
-        boxstyle.mLanguage = QString(value);
-    }
-    else if(property == "highlight") {
-        if(value == "false") {
-            boxstyle.mHighlight = false;
-        }
-        else if(value == "true") {
-            boxstyle.mHighlight = true;
-        }
-        else {
-            throw PorpertyConversionError {
-                "Invalid value for 'highlight' (possible values: true, false)",
-                line
-            };
-        }
-    }
-    else if(property == "background") {
-        QColor color;
-        color.setNamedColor(value);
-        if(!color.isValid()) {
-            throw PorpertyConversionError {"Invalid color", line};
+    };
+    table[int(PropertyId::Top)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mGeometry.setTop(toInt(value, line));
+        boxstyle.movable = false;
+    };
+    table[int(PropertyId::Width)] = [](QString const& value, int line, BoxStyle & boxstyle) {
+        boxstyle.mGeometry.setWidth(toInt(value, line));
+        boxstyle.movable = false;
+    };
+    return table;
+}();
+static_assert(std::ranges::none_of(propertyParsers, [](PropertyParser parser){ return parser == nullptr; }),
+              "every property needs a parser");
+
+// properties that differ for nearly every box, they are not part of the memoized styles
+bool boxSpecificProperty(PropertyId property) {
+    return property == PropertyId::Text || property == PropertyId::Id;
+}
+
+std::atomic<qint64> memoHits = 0;
+std::atomic<qint64> memoMisses = 0;
+
+// Converted styles by the values they were converted from. The styles are converted
+// in the build thread and, for the slides that are styled when they are painted, in
+// the UI thread.
+class StyleMemo {
+public:
+    using Key = std::vector<std::pair<PropertyId, QString>>;
+
+    std::shared_ptr<BoxStyle const> style(Key const& key, std::function<BoxStyle()> const& convert) {
+        {
+            QMutexLocker lock(&mMutex);
+            if(auto const style = mStyles.find(key); style != mStyles.end()) {
+                memoHits++;
+                return style->second;
+            }
         }
-        boxstyle.mBackgroundColor = color;
-    }
-    else if(property == "background-color") {
-        QColor color;
-        color.setNamedColor(value);
-        if(!color.isValid()) {
-            throw PorpertyConversionError {"Invalid color", line};
+        memoMisses++;
+        auto style = std::make_shared<BoxStyle const>(convert());
+        QMutexLocker lock(&mMutex);
+        // the values of the edited boxes pile up, the memo starts over when it gets too large
+        if(mStyles.size() >= maximalSize) {
+            mStyles.clear();
         }
-        boxstyle.mBackgroundColor = color;
+        mStyles.emplace(key, style);
+        return style;
     }
-    else if(property == "padding") {
-        boxstyle.mPadding = value.toInt(&numberOk);
-    }
-    else if(property == "border-radius") {
-        boxstyle.mBorderRadius = value.toInt(&numberOk);
-    }
-    else if(property == "border") {
-        static auto const borderStyles = std::set<QString>{"solid", "dashed", "dotted", "double"};
-        bool borderOk = true;
-        auto values = QString(value).split(" ");
-        if(values.empty()) {
-            throw PorpertyConversionError {
-                "Give border in format: \"border: border-width px border-style (required) border color\", e.g. \"4px solid red\"",
-                line
-            };
-        }
-        if (values[0].endsWith("px") && values.length() >= 2) {
-            auto value = values[0];
-            value.chop(2);
-            boxstyle.mBorder.width = value.toInt(&borderOk);
-            if(borderStyles.find(values[1]) != borderStyles.end()) {
-                boxstyle.mBorder.style = values[1];
-            }
-            else {
-                borderOk = false;
-            }
-            if (values.length() >= 3) {
-                auto const color = QColor(QString(values[2]));
-                borderOk = borderOk && color.isValid();
-                boxstyle.mBorder.color = color;
-            }
-        }
-        else {
-            if(borderStyles.find(values[0]) != borderStyles.end()) {
-                boxstyle.mBorder.style = values[0];
-            }
-            else {
-                borderOk = false;
-            }
-            if(values.length() >= 2) {
-                auto const color = QColor(QString(values[1]));
-                borderOk = borderOk && color.isValid();
-                boxstyle.mBorder.color = color;
+
+private:
+    struct KeyHash {
+        size_t operator()(Key const& key) const {
+            auto hash = qHash(int(key.size()));
+            for(auto const& [property, value]: key) {
+                hash = qHash(std::pair(int(property), qHash(value)), hash);
             }
+            return hash;
         }
-        if(!borderOk) {
-            throw PorpertyConversionError {
-                "Give border in format: \"border: border-width px border-style (required) border color\", e.g. \"4px solid red\"",
-                line
-            };
+    };
+
+    static std::size_t constexpr maximalSize = 10000;
+    QMutex mMutex;
+    std::unordered_map<Key, std::shared_ptr<BoxStyle const>, KeyHash> mStyles;
+};
+
+}
+
+std::shared_ptr<BoxStyle const> propertyMapToBoxStyle(const Box::Properties &properties) {
+    StyleMemo::Key key;
+    key.reserve(properties.size());
+    for (auto const& entry: properties) {
+        if(!boxSpecificProperty(entry.first)) {
+            key.emplace_back(entry.first, entry.second.mValue);
         }
     }
-    else if (property == "marker") {
-        auto values = QString(value).split(" ");
-        if(values.empty()) {
-            throw PorpertyConversionError{
-                "Give marker in the format: \"marker: color (required) font-weight (optional)\", e.g. blue bold, red",
-                line
-            };
-        }
-        if(values[0] == "bold") {
-            boxstyle.mTextMarker.fontWeight = FontWeight::bold;
+    // a conversion error is not memoized, it is thrown with the line of the box
+    static StyleMemo memo;
+    return memo.style(key, [&properties](){
+        BoxStyle boxStyle;
+        for (auto const& entry: properties) {
+            if(!boxSpecificProperty(entry.first)) {
+                applyProperty(entry.first, entry.second, boxStyle);
+            }
         }
-        else if(values[0] == "normal") {
-            boxstyle.mTextMarker.fontWeight = FontWeight::normal;
+        return boxStyle;
+    });
+}
+
+std::shared_ptr<BoxStyle const> variablesToBoxStyle(Variables const& variables) {
+    // the variables that are properties in the order of their ids, the sorted list is the key of the memo
+    StyleMemo::Key key;
+    variables.forEach([&key](QString const& name, QString const& value) {
+        // variables without the brackets %{ } that are no property are ignored
+        if(auto const property = propertyId(QStringView(name).mid(2, name.size() - 3))) {
+            key.emplace_back(property.value(), value);
         }
-        else {
-            boxstyle.mTextMarker.color = QColor(QString(values[0]));
-            if(values.length() > 1) {
-                if(values[1] == "bold") {
-                    boxstyle.mTextMarker.fontWeight = FontWeight::bold;
-                }
-                else if(values[1] == "normal") {
-                    boxstyle.mTextMarker.fontWeight = FontWeight::normal;
-                }
+    });
+    std::ranges::sort(key, {}, &std::pair<PropertyId, QString>::first);
+    static StyleMemo memo;
+    return memo.style(key, [&key](){
+        BoxStyle boxStyle;
+        for (auto const& [property, value]: key) {
+            try {
+                applyProperty(property, value, 0, boxStyle);
+            }  catch (PorpertyConversionError) {
+
             }
         }
-    }
-    else {
-        throw PorpertyConversionError {
-            QString("Invalid Argument %1.").arg(property),
-            line
-        };
-    }
-    if(!numberOk) {
-        throw PorpertyConversionError {
-            "Invalid number",
-            line
-        };
-    }
+        return boxStyle;
+    });
+}
+
+StyleMemoStatistics styleMemoStatistics() {
+    return {memoHits.load(), memoMisses.load()};
+}
+
+void applyProperty(PropertyId property, const QString &value, int line, BoxStyle & boxstyle) {
+    propertyParsers[int(property)](value, line, boxstyle);
 }
 
-void applyProperty(QString const& property, PropertyEntry const& entry, BoxStyle & boxstyle) {
+void applyProperty(PropertyId property, PropertyEntry const& entry, BoxStyle & boxstyle) {
     applyProperty(property, entry.mValue, entry.mLine, boxstyle);
 }
 
@@ -7,10 +7,21 @@
 #pragma once
 #include "box.h"
 
-BoxStyle propertyMapToBoxStyle(Box::Properties const& properties);
-BoxStyle variablesToBoxStyle(Variables const& variables);
+// The converted styles are memoized by the values of the properties, boxes with the
+// same properties and slides with the same variables share one style.
+// The style of the properties of a box has no text and id, they differ for nearly every box.
+std::shared_ptr<BoxStyle const> propertyMapToBoxStyle(Box::Properties const& properties);
+std::shared_ptr<BoxStyle const> variablesToBoxStyle(Variables const& variables);
 
-void applyProperty(QString const& property, QString const& value, int line, BoxStyle & boxstyle);
-void applyProperty(QString const& property, PropertyEntry const& entry, BoxStyle & boxstyle);
+// counts the conversions that were taken from the memo (hits) and done (misses) since the start
+struct StyleMemoStatistics {
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+StyleMemoStatistics styleMemoStatistics();
+
+// throws PorpertyConversionError if the value is invalid for the property
+void applyProperty(PropertyId property, QString const& value, int line, BoxStyle & boxstyle);
+void applyProperty(PropertyId property, PropertyEntry const& entry, BoxStyle & boxstyle);
 
 Box::List copy(Box::List const& input);
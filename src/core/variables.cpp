@@ -0,0 +1,136 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#include "variables.h"
+
+namespace {
+
+template<typename Scope>
+std::optional<QString> findInScope(Scope const& scope, QString const& name) {
+    if(!scope) {
+        return {};
+    }
+    if(auto const value = scope->find(name); value != scope->end()) {
+        return value.value();
+    }
+    return {};
+}
+
+template<typename ScopePtr>
+bool sameScope(ScopePtr const& scope, ScopePtr const& other) {
+    return scope == other || (scope && other && *scope == *other);
+}
+
+template<typename Scope>
+bool hasVisibleVariable(Scope const& scope, QSet<QString> const& removed) {
+    if(!scope) {
+        return false;
+    }
+    for(auto it = scope->keyBegin(); it != scope->keyEnd(); it++) {
+        if(!removed.contains(*it)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+bool Variables::contains(QString const& name) const {
+    return value(name).has_value();
+}
+
+std::optional<QString> Variables::value(QString const& name) const {
+    if(auto const own = mOwn.find(name); own != mOwn.end()) {
+        return own.value();
+    }
+    if(!mRemoved.isEmpty() && mRemoved.contains(name)) {
+        return {};
+    }
+    if(auto const shared = findInScope(mParent, name)) {
+        return shared;
+    }
+    return findInScope(mFallback, name);
+}
+
+void Variables::set(QString const& name, QString const& value) {
+    mOwn.insert(name, value);
+    mRemoved.remove(name);
+}
+
+std::optional<QString> Variables::remove(QString const& name) {
+    auto const oldValue = value(name);
+    if(!oldValue) {
+        return {};
+    }
+    mOwn.remove(name);
+    if((mParent && mParent->contains(name)) || (mFallback && mFallback->contains(name))) {
+        mRemoved.insert(name);
+    }
+    return oldValue;
+}
+
+bool Variables::empty() const {
+    return mOwn.isEmpty() && !hasVisibleVariable(mParent, mRemoved) && !hasVisibleVariable(mFallback, mRemoved);
+}
+
+void Variables::share() {
+    auto scope = sharedScope();
+    *this = Variables();
+    mParent = std::move(scope);
+}
+
+void Variables::setFallback(Variables const& fallback) {
+    mFallback = fallback.sharedScope();
+}
+
+std::map<QString, QString> Variables::toMap() const {
+    std::map<QString, QString> variables;
+    forEach([&variables](QString const& name, QString const& value) {
+        variables.emplace(name, value);
+    });
+    return variables;
+}
+
+bool Variables::operator==(Variables const& other) const {
+    // copies of the same variables share their scopes, mostly only the own variables differ
+    if(mOwn == other.mOwn && mRemoved == other.mRemoved
+            && sameScope(mParent, other.mParent) && sameScope(mFallback, other.mFallback)) {
+        return true;
+    }
+    // the same variables can be set in different scopes
+    auto equal = true;
+    auto count = 0;
+    forEach([&equal, &count, &other](QString const& name, QString const& value) {
+        count++;
+        if(equal && other.value(name) != value) {
+            equal = false;
+        }
+    });
+    if(!equal) {
+        return false;
+    }
+    auto otherCount = 0;
+    other.forEach([&otherCount](QString const&, QString const&) {
+        otherCount++;
+    });
+    return count == otherCount;
+}
+
+bool Variables::operator!=(Variables const& other) const {
+    return !(*this == other);
+}
+
+Variables::ScopePtr Variables::sharedScope() const {
+    if(mOwn.isEmpty() && mRemoved.isEmpty() && !mFallback) {
+        return mParent;
+    }
+    auto scope = std::make_shared<Scope>();
+    forEach([&scope](QString const& name, QString const& value) {
+        scope->insert(name, value);
+    });
+    return scope;
+}
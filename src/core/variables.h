@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2020-2021 Theresa Gier <theresa@fam-gier.de>
+
+    SPDX-License-Identifier: LGPL-2.1-or-later
+*/
+
+#ifndef VARIABLES_H
+#define VARIABLES_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <map>
+#include <memory>
+#include <optional>
+
+// The variables of a slide, e.g. %{pagenumber}. Variables set before a slide are kept
+// in an immutable scope that all slides with the same variables share, the slide
+// itself only stores the variables set for it. Lookups check the own variables,
+// the shared scope and the fallback, e.g. the variables of the template.
+class Variables
+{
+public:
+    Variables() = default;
+
+    bool contains(QString const& name) const;
+    std::optional<QString> value(QString const& name) const;
+    void set(QString const& name, QString const& value);
+    std::optional<QString> remove(QString const& name);
+    bool empty() const;
+
+    // moves the own variables into a shared scope, copies made afterwards share it
+    void share();
+    // variables that are not set are looked up in the fallback
+    void setFallback(Variables const& fallback);
+
+    // calls function(name, value) for every visible variable, in no particular order
+    template<typename Function>
+    void forEach(Function function) const;
+    // all visible variables sorted by name
+    std::map<QString, QString> toMap() const;
+
+    // compares the visible variables
+    bool operator==(Variables const& other) const;
+    bool operator!=(Variables const& other) const;
+
+private:
+    using Scope = QHash<QString, QString>;
+    using ScopePtr = std::shared_ptr<Scope const>;
+
+    // the scope with all visible variables, it is only created if there are own ones
+    ScopePtr sharedScope() const;
+
+private:
+    Scope mOwn;
+    // variables of the shared scope or the fallback that were removed
+    QSet<QString> mRemoved;
+    ScopePtr mParent;
+    ScopePtr mFallback;
+};
+
+template<typename Function>
+void Variables::forEach(Function function) const {
+    for(auto it = mOwn.begin(); it != mOwn.end(); it++) {
+        function(it.key(), it.value());
+    }
+    // a variable of an outer scope is hidden by the own variables, the removed ones and the inner scopes
+    auto const visible = [this](QString const& name, Scope const* inner) {
+        return !mOwn.contains(name) && !mRemoved.contains(name) && !(inner && inner->contains(name));
+    };
+    if(mParent) {
+        for(auto it = mParent->begin(); it != mParent->end(); it++) {
+            if(visible(it.key(), nullptr)) {
+                function(it.key(), it.value());
+            }
+        }
+    }
+    if(mFallback) {
+        for(auto it = mFallback->begin(); it != mFallback->end(); it++) {
+            if(visible(it.key(), mParent.get())) {
+                function(it.key(), it.value());
+            }
+        }
+    }
+}
+
+#endif // VARIABLES_H
@@ -40,6 +40,7 @@
 #include "potatoformatvisitor.h"
 #include "transformboxundo.h"
 #include "version.h"
+#include "parsecache.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -62,6 +63,15 @@ MainWindow::MainWindow(QWidget *parent)
     mPresentation = std::make_shared<Presentation>();
     mSlideWidget = ui->slideWidget;
     mSlideWidget->setPresentation(mPresentation);
+    mBuilder = new PresentationBuilder(this);
+    connect(mBuilder, &PresentationBuilder::finished,
+            this, &MainWindow::buildFinished);
+    mRebuildScheduler = new RebuildScheduler(this);
+    connect(mRebuildScheduler, &RebuildScheduler::rebuildRequested,
+            this, &MainWindow::startBuild);
+    mIncludeWatcher = new QFileSystemWatcher(this);
+    connect(mIncludeWatcher, &QFileSystemWatcher::fileChanged,
+            this, &MainWindow::fileChanged);
     connect(&mTemplateCache, &TemplateCache::templateChanged,
             this, [this](){
         mTemplateCache.resetTemplate();
@@ -266,50 +276,57 @@ void MainWindow::closeEvent(QCloseEvent *event) {
 }
 
 void MainWindow::fileChanged() {
-    auto iface = qobject_cast<KTextEditor::MarkInterface*>(mDoc);
-    iface->clearMarks();
-    auto const text = mDoc->text().toUtf8().toStdString();
-    auto const parserOutput = generateSlides(text, fileDirectory());
-    if(parserOutput.successfull()) {
-        auto const slides = parserOutput.slideList();
-        auto const preamble = parserOutput.preamble();
-        auto templateName = preamble.templateName;
-        Template::Ptr presentationTemplate = nullptr;
-        if(!templateName.isEmpty()) {
-            if (!QDir::isAbsolutePath(templateName)) {
-                templateName = fileDirectory() + "/" + templateName;
-            }
-            presentationTemplate = mTemplateCache.getTemplate(templateName);
-            if (!presentationTemplate) {
-                presentationTemplate = readTemplate(templateName);
-                if(!presentationTemplate) {
-                    mErrorOutput->setText("Line " + QString::number(parserOutput.preamble().line + 1) +
-                                          ": Cannot load template" + " \u26A0");
-                    iface->addMark(parserOutput.preamble().line, KTextEditor::MarkInterface::MarkTypes::Error);
-                    return;
-                }
-                mTemplateCache.setTemplate(presentationTemplate, templateName);
-            }
+    mRebuildScheduler->schedule();
+}
+
+void MainWindow::startBuild() {
+    mBuilder->build(mDoc->text(), fileDirectory(), mPresentation->configuration(), mPresentation->configRevision(),
+                    mTemplateCache.getTemplate(mTemplateCache.path()), mTemplateCache.path());
+}
+
+void MainWindow::buildFinished(BuildResult const& result) {
+    // the time of the rebuild is measured until the slides are repainted
+    QTimer::singleShot(0, mRebuildScheduler, &RebuildScheduler::rebuildFinished);
+    // only the changed includes are given to the watcher, a file that is replaced on save
+    // is removed from the watcher and added again here
+    auto const watchedFiles = mIncludeWatcher->files();
+    QStringList removedFiles;
+    for(auto const& file: watchedFiles) {
+        if(!result.mIncludedFiles.contains(file)) {
+            removedFiles.append(file);
         }
-        try {
-            mPresentation->setData({slides, presentationTemplate});
-        }  catch (PorpertyConversionError error) {
-            mErrorOutput->setText("Line " + QString::number(error.line + 1) + ": " + error.message + " \u26A0");
-            iface->addMark(error.line, KTextEditor::MarkInterface::MarkTypes::Error);
-            return;
+    }
+    QStringList addedFiles;
+    for(auto const& file: result.mIncludedFiles) {
+        if(!watchedFiles.contains(file)) {
+            addedFiles.append(file);
         }
-        mErrorOutput->setText("Conversion succeeded \u2714");
     }
-    else {
-        auto const error = parserOutput.parserError();
+    if(!removedFiles.isEmpty()) {
+        mIncludeWatcher->removePaths(removedFiles);
+    }
+    if(!addedFiles.isEmpty()) {
+        mIncludeWatcher->addPaths(addedFiles);
+    }
+    auto iface = qobject_cast<KTextEditor::MarkInterface*>(mDoc);
+    iface->clearMarks();
+    if(result.mError) {
+        auto const error = result.mError.value();
         mErrorOutput->setText("Line " + QString::number(error.line + 1) + ": " + error.message + " \u26A0");
         iface->addMark(error.line, KTextEditor::MarkInterface::MarkTypes::Error);
+    }
+    if(!result.mData) {
         return;
     }
+    if(result.mLoadedTemplate) {
+        mTemplateCache.setTemplate(result.mLoadedTemplate, result.mTemplatePath);
+    }
+    mPresentation->setConfiguredData(result.mData.value(), result.mConfigRevision);
+    if(!result.mError) {
+        mErrorOutput->setText("Conversion succeeded \u2714");
+    }
 
-    mSlideWidget->updateSlideId();
-    mSlideWidget->update();
-    mSlideModel->setPresentation(mPresentation);
+    // the slide widget and the model follow the changes of the slides themselves
     auto const index = mSlideModel->index(mSlideWidget->pageNumber());
     ui->pagePreview->selectionModel()->select(index, QItemSelectionModel::ClearAndSelect);
     ui->pagePreview->scrollTo(index);
@@ -320,34 +337,10 @@ std::shared_ptr<Template> MainWindow::readTemplate(QString templateName) const {
     if(templateName.isEmpty()) {
         return {};
     }
-    auto file = QFile(templateName + ".potato");
-    if(!file.open(QIODevice::ReadOnly)){
-        mErrorOutput->setText(tr("Cannot load template %1.").arg(file.fileName()));
-        return {};
-    }
-    auto thisTemplate = std::make_shared<Template>();
     try {
-        thisTemplate->setConfig(templateName + ".json");
-    }  catch (ConfigError error) {
-        mErrorOutput->setText(tr("Cannot load template %1.").arg(error.filename));
-        return {};
-    }
-    auto const directoryPath = QFileInfo(templateName).absolutePath();
-    auto const parserOutput = generateSlides(file.readAll().toStdString(), directoryPath, true);
-
-    if(parserOutput.successfull()) {
-        auto const slides = parserOutput.slideList();
-        try {
-            thisTemplate->setData(slides);
-        }  catch (PorpertyConversionError & error) {
-            mErrorOutput->setText("Cannot load template: Line " + QString::number(error.line + 1) + ": " + error.message + " \u26A0");
-            return {};
-        }
-        return thisTemplate;
-    }
-    else {
-        auto const error = parserOutput.parserError();
-        mErrorOutput->setText("Cannot load template \u26A0");
+        return loadTemplate(templateName);
+    }  catch (TemplateError error) {
+        mErrorOutput->setText(error.message);
         return {};
     }
 }
@@ -445,6 +438,7 @@ void MainWindow::openProject(QString path) {
 
     ui->mainWidget->setCurrentIndex(0);
     newDocument();
+    mBuilder->setCacheFile(parseCacheFileName(QFileInfo(path).absoluteFilePath()));
     openInputFile(path);
     mPresentation->setConfig({jsonFileName()});
     mSlideWidget->setPresentation(mPresentation);
@@ -480,6 +474,8 @@ void MainWindow::newDocument() {
         mIsModified = true;
     }});
     setupFileActionsFromKPart();
+    mBuilder->clear();
+    mRebuildScheduler->reset();
     resetPresentation();
     mViewTextDoc->setFocus();
     mDoc->setHighlightingMode("LaTeX");
@@ -509,6 +505,7 @@ bool MainWindow::save() {
     }
     QFile::remove(autosaveTextFile());
     saveJson();
+    mBuilder->saveCache();
     ui->statusbar->showMessage(tr("Saved File to  \"%1\".").arg(mDoc->url().toLocalFile()), 10000);
     setWindowTitle(windowTitle());
     mIsModified = false;
@@ -522,6 +519,8 @@ bool MainWindow::saveAs(){
     QFile::remove(autosaveTextFile());
     saveJson();
     fileChanged();
+    mBuilder->setCacheFile(parseCacheFileName(absoluteFilePath()));
+    mBuilder->saveCache();
     ui->statusbar->showMessage(tr("Saved File to  \"%1\".").arg(mDoc->url().toLocalFile()), 10000);
     setWindowTitle(windowTitle());
     mIsModified = false;
@@ -714,18 +713,17 @@ bool MainWindow::closeDocument() {
 }
 
 Presentation::Ptr MainWindow::generateTemplatePresentation(QString directory) const {
-    QFile file(directory + "/demo.potato");
-    if (!file.open(QIODevice::ReadOnly)) {
+    auto const fileName = directory + "/demo.potato";
+    if (!QFile::exists(fileName)) {
         return {};
     }
-    auto const val = file.readAll();
 
     auto presentation = std::make_shared<Presentation>();
     presentation->setConfig({directory + "/demo.json"});
 
-    auto const parserOutput = generateSlides(val.toStdString(), directory);
+    auto parserOutput = generateSlidesFromFile(fileName, directory);
     if(parserOutput.successfull()) {
-        auto const slides = parserOutput.slideList();
+        auto slides = parserOutput.takeSlideList();
         auto const preamble = parserOutput.preamble();
         auto templateName = preamble.templateName;
         if (!QDir::isAbsolutePath(templateName)) {
@@ -733,7 +731,7 @@ Presentation::Ptr MainWindow::generateTemplatePresentation(QString directory) co
         }
         auto const presentationTemplate = readTemplate(templateName);
         try {
-            presentation->setData({slides, presentationTemplate});
+            presentation->setData({std::move(slides), presentationTemplate});
         }  catch (PorpertyConversionError) {
             return {};
         }
@@ -16,6 +16,7 @@
 #include <QLabel>
 #include <QToolButton>
 #include <QSettings>
+#include <QFileSystemWatcher>
 
 #include <KTextEditor/Document>
 #include <KTextEditor/Editor>
@@ -28,6 +29,8 @@
 #include "templatelistmodel.h"
 #include "template.h"
 #include "templatecache.h"
+#include "presentationbuilder.h"
+#include "rebuildscheduler.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -44,7 +47,10 @@ public:
 private Q_SLOTS:
 
 private:
+    // schedules a rebuild of the presentation
     void fileChanged();
+    void startBuild();
+    void buildFinished(BuildResult const& result);
     void setupFileActionsFromKPart();
     void openInputFile(QString filename);
     void newDocument();
@@ -142,6 +148,10 @@ private:
     Presentation::Ptr mPresentation;
     QString mTemplatePath;
     TemplateCache mTemplateCache;
+    PresentationBuilder* mBuilder;
+    RebuildScheduler* mRebuildScheduler;
+    // files included by the document, a change rebuilds the presentation
+    QFileSystemWatcher* mIncludeWatcher;
 
     QListWidget *mListWidget;
     SlideListModel *mSlideModel;
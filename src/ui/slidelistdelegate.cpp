@@ -35,12 +35,15 @@ void SlideListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
     QFont font = painter->font();
     font.setPixelSize(100);
     painter->setFont(font);
-    if(option.state & QStyle::State_Selected){
+    // the slide shows its last version because its text has an error
+    auto const label = slide->outdated() ? slide->id() + " \u26A0" : slide->id();
+    if(slide->outdated()) {
+        painter->setPen(Qt::red);
+    }
+    else if(option.state & QStyle::State_Selected){
         painter->setPen(option.palette.HighlightedText);
-        painter->drawText(QRect(0, 900, 1700, 200), Qt::AlignCenter, slide->id());
-    }else{
-        painter->drawText(QRect(0, 900, 1700, 200), Qt::AlignCenter, slide->id());
     }
+    painter->drawText(QRect(0, 900, 1700, 200), Qt::AlignCenter, label);
 
     painter->setPen(Qt::blue);
     painter->drawRect(QRect(0, 0, 1600, 900));
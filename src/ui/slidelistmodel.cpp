@@ -7,8 +7,10 @@
 #include "slidelistmodel.h"
 #include "presentation.h"
 
+#include <algorithm>
+
 int SlideListModel::rowCount(const QModelIndex &) const {
-    return int(mPresentation->slideList().numberSlides());
+    return int(mSlides.size());
 }
 
 QVariant SlideListModel::data(const QModelIndex &index, int role) const
@@ -16,12 +18,12 @@ QVariant SlideListModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    if (index.row() >= mPresentation->numberOfSlides())
+    if (index.row() >= rowCount())
         return QVariant();
 
     if (role == Qt::DisplayRole){
         QVariant var;
-        auto slide = mPresentation->slideList().vector[index.row()];
+        auto slide = mSlides[index.row()];
         var.setValue(slide);
         return var;
     }
@@ -33,22 +35,84 @@ void SlideListModel::setPresentation(std::shared_ptr<Presentation> presentation)
     if(mPresentation){
         mPresentation->disconnect(this);
     }
-    beginResetModel();
     mPresentation = presentation;
-    endResetModel();
-    mNumberOfSlides = rowCount();
+    resetSlides();
     connect(mPresentation.get(), &Presentation::slideChanged,
             this, &SlideListModel::slidesChanged);
+    connect(mPresentation.get(), &Presentation::slideListChanged,
+            this, &SlideListModel::applyDiff);
 }
 
 void SlideListModel::slidesChanged(int firstSlide, int lastSlide) {
-    if (mPresentation->numberOfSlides() == mNumberOfSlides) {
+    if (mPresentation->numberOfSlides() == rowCount()) {
         Q_EMIT dataChanged(index(firstSlide), index(lastSlide));
         return;
     }
-    beginResetModel();
-    endResetModel();
-    mNumberOfSlides = rowCount();
+    resetSlides();
 }
 
+void SlideListModel::applyDiff(SlideListDiff const& diff) {
+    auto const& slides = mPresentation->slideList().vector;
+    if(diff.oldPositions.size() != slides.size() || diff.removed.size() + slides.size() - diff.inserted.size() != mSlides.size()) {
+        resetSlides();
+        return;
+    }
+
+    // old position of the slide in each row
+    std::vector<int> rows(mSlides.size());
+    for(int i = 0; i < int(rows.size()); i++) {
+        rows[i] = i;
+    }
+    // from the back, so that the positions of the old list stay valid
+    for(auto removed = diff.removed.rbegin(); removed != diff.removed.rend();) {
+        auto const last = *removed;
+        auto first = last;
+        while(++removed != diff.removed.rend() && *removed == first - 1) {
+            first--;
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        mSlides.erase(mSlides.begin() + first, mSlides.begin() + last + 1);
+        rows.erase(rows.begin() + first, rows.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    for(int i = 0; i < int(slides.size());) {
+        if(diff.oldPositions[i] < 0) {
+            auto last = i;
+            while(last + 1 < int(slides.size()) && diff.oldPositions[last + 1] < 0) {
+                last++;
+            }
+            beginInsertRows(QModelIndex(), i, last);
+            mSlides.insert(mSlides.begin() + i, slides.begin() + i, slides.begin() + last + 1);
+            rows.insert(rows.begin() + i, last - i + 1, -1);
+            endInsertRows();
+            i = last + 1;
+            continue;
+        }
+        auto const row = int(std::find(rows.begin() + i, rows.end(), diff.oldPositions[i]) - rows.begin());
+        if(row != i) {
+            beginMoveRows(QModelIndex(), row, row, QModelIndex(), i);
+            std::rotate(mSlides.begin() + i, mSlides.begin() + row, mSlides.begin() + row + 1);
+            std::rotate(rows.begin() + i, rows.begin() + row, rows.begin() + row + 1);
+            endMoveRows();
+        }
+        // the row shows the slide of the new data, it is only painted again if it was modified
+        mSlides[i] = slides[i];
+        i++;
+    }
 
+    for(auto modified = diff.modified.begin(); modified != diff.modified.end();) {
+        auto const first = *modified;
+        auto last = first;
+        while(++modified != diff.modified.end() && *modified == last + 1) {
+            last++;
+        }
+        Q_EMIT dataChanged(index(first), index(last));
+    }
+}
+
+void SlideListModel::resetSlides() {
+    beginResetModel();
+    mSlides = mPresentation ? mPresentation->slideList().vector : std::vector<Slide::Ptr>();
+    endResetModel();
+}
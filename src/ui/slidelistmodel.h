@@ -10,6 +10,7 @@
 #include <vector>
 #include <memory>
 #include "slide.h"
+#include "slidelistdiff.h"
 
 class Presentation;
 
@@ -28,10 +29,14 @@ public:
 
 private:
     void slidesChanged(int firstSlide, int lastSlide);
+    // inserts, removes and moves the rows one after another and updates the modified ones
+    void applyDiff(SlideListDiff const& diff);
+    void resetSlides();
 
 private:
     std::shared_ptr<Presentation> mPresentation = nullptr;
-    int mNumberOfSlides = 0;
+    // the slides of the rows, they follow the presentation step by step while a diff is applied
+    std::vector<Slide::Ptr> mSlides;
 };
 
 #endif // FRAMELISTMODEL_H
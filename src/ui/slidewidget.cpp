@@ -54,10 +54,25 @@ void SlideWidget::setPresentation(std::shared_ptr<Presentation> pres){
     mCurrentSlideId = QString();
     connect(mPresentation.get(), &Presentation::slideChanged,
             this, QOverload<>::of(&SlideWidget::update));
+    connect(mPresentation.get(), &Presentation::slideListChanged,
+            this, &SlideWidget::slideListChanged);
     mUndoStack.clear();
     update();
 }
 
+void SlideWidget::slideListChanged(SlideListDiff const& diff) {
+    auto const pageNumber = mPageNumber;
+    updateSlideId();
+    if(mPageNumber >= int(diff.oldPositions.size())) {
+        update();
+        return;
+    }
+    // another slide is shown at the page, e.g. after the slide was removed
+    if(mPageNumber != pageNumber || diff.oldPositions[mPageNumber] != pageNumber || diff.changed(mPageNumber)) {
+        update();
+    }
+}
+
 void SlideWidget::recalculateGeometry() {
     // Compute geometry of inner slide
     QPoint marginLeft = {8, 8};
@@ -133,7 +148,7 @@ void SlideWidget::paintEvent(QPaintEvent*)
     painter.setClipRect(QRect(QPoint(0, 0), mSize));
 
     SlideRenderer paint(painter);
-    auto const slide = mPresentation->data().slideListDefaultApplied().slideAt(mPageNumber);
+    auto const slide = mPresentation->slideList().slideAt(mPageNumber);
     paint.paintSlide(slide);
     mCurrentSlideId = slide->id();
 
@@ -475,7 +490,7 @@ void SlideWidget::deleteBoxPosition() {
         return;
     }
     auto const lastConfig = mPresentation->configuration();
-    mPresentation->deleteBoxGeometry(mActiveBoxId, mPageNumber);
+    mPresentation->deleteBoxGeometry(mActiveBoxId);
     auto transform = new TransformBoxUndo(mPresentation, lastConfig, mPresentation->configuration());
     mUndoStack.push(transform);
 }
@@ -485,7 +500,7 @@ void SlideWidget::deleteBoxAngle() {
         return;
     }
     auto const lastConfig = mPresentation->configuration();
-    mPresentation->deleteBoxAngle(mActiveBoxId, mPageNumber);
+    mPresentation->deleteBoxAngle(mActiveBoxId);
     auto transform = new TransformBoxUndo(mPresentation, lastConfig, mPresentation->configuration());
     mUndoStack.push(transform);
 }
@@ -611,10 +626,9 @@ void SlideWidget::setSnapping(bool snapping) {
 
 QString SlideWidget::absoluteImagePath(QString imagePath) const {
     if(!QDir::isAbsolutePath(imagePath)) {
-        auto variables = mPresentation->slideList().vector[mPageNumber]->variables();
-        auto it = variables.find("%{resourcepath}");
-        if(it != variables.end()) {
-            imagePath = it->second + "/" + imagePath;
+        auto const resourcePath = mPresentation->slideList().vector[mPageNumber]->variables().value("%{resourcepath}");
+        if(resourcePath) {
+            imagePath = resourcePath.value() + "/" + imagePath;
         }
     }
     return imagePath;
@@ -69,6 +69,8 @@ private:
     void keyPressEvent(QKeyEvent *event) override;
 
     void recalculateGeometry();
+    // repaints only if the shown slide changed
+    void slideListChanged(SlideListDiff const& diff);
 
     // Mouse interaction / apperance
     // scale mouse position to viewport of widget